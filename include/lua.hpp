@@ -4,3 +4,9 @@
 #include "lua/Lexer.hpp"
 #include "lua/Parser.hpp"
 #include "lua/EntryContext.hpp"
+#include "lua/Aot.hpp"
+#include "lua/CompileService.hpp"
+#include "lua/Scheduler.hpp"
+#include "lua/PageCache.hpp"
+#include "lua/ReadCache.hpp"
+#include "lua/WriteBuffer.hpp"
@@ -1,9 +1,9 @@
 #pragma once
 
-#include <vector>
-
 #include "ASTFwd.hpp"
+#include "Arena.hpp"
 #include "Object.hpp"
+#include "ObjectOps.hpp"
 #include "Token.hpp"
 
 namespace CTRPluginFramework::lua::ast {
@@ -36,6 +36,18 @@ enum class ExprKind {
   LogOr,
 };
 
+// Mul .. BitOr are evaluated by binary_op(), in the same order as BinOp.
+constexpr auto is_binop(ExprKind k) -> bool {
+  return ExprKind::Mul <= k && k <= ExprKind::BitOr;
+}
+
+constexpr auto binop_of(ExprKind k) -> BinOp {
+  return static_cast<BinOp>(static_cast<int>(k) -
+                            static_cast<int>(ExprKind::Mul));
+}
+
+static_assert(binop_of(ExprKind::BitOr) == BinOp::BitOr);
+
 enum class StmtKind {
   Assign,
   Expr,
@@ -65,8 +77,6 @@ struct Tree {
 
   virtual bool is_terms() const { return false; }
 
-  virtual ~Tree() = default;
-
  protected:
   Tree(Kind kind, Token *token) : kind(kind), token(token) {}
 };
@@ -74,14 +84,16 @@ struct Tree {
 struct Expr : public Tree {
   ExprKind kind;
 
+  // kind of every value of this expression, given by TypeInfer.
+  // None if it is not proven.
+  TypeKind type = TypeKind::None;
+
   bool is(ExprKind k) const { return kind == k; }
 
   bool is_terms() const override {
     return ExprKind::Mul <= kind && kind <= ExprKind::LogOr;
   }
 
-  virtual ~Expr() = default;
-
  protected:
   Expr(ExprKind kind, Token *token) : Tree(Kind::Expr, token), kind(kind) {}
 };
@@ -91,8 +103,6 @@ struct Stmt : public Tree {
 
   bool is(StmtKind k) const { return kind == k; }
 
-  virtual ~Stmt() = default;
-
  protected:
   Stmt(StmtKind k, Token *tok) : Tree(Kind::Stmt, tok), kind(k) {}
 };
@@ -107,50 +117,52 @@ struct Value final : public Expr {
 struct Variable final : public Expr {
   StringID name;
 
+  // index into the global storage, given by Resolver.
+  u16 slot = 0;
+
   Variable(Token *token) : Expr(ExprKind::Variable, token), name(token->str) {}
 };
 
 struct CallFunc final : public Expr {
   Expr *functor;
-  std::vector<Expr *> args;
+  ArenaVec<Expr *> args;
+
+  // index in NativeRegistry, bound by Resolver.
+  int native = -1;
 
-  ~CallFunc();
-  CallFunc(Expr *f, Token *B) : Expr(ExprKind::CallFunc, B), functor(f) {}
+  CallFunc(Arena &A, Expr *f, Token *B)
+      : Expr(ExprKind::CallFunc, B), functor(f), args(A) {}
 };
 
 struct Terms final : public Expr {
   Expr *base;
-  std::vector<std::pair<Token *, Expr *>> terms;
+  ArenaVec<std::pair<Token *, Expr *>> terms;
 
   Expr *append(Token *op, Expr *item) {
     return terms.emplace_back(op, item).second;
   }
 
-  static Terms *make(ExprKind kind, Token *op, Expr *lhs, Expr *rhs) {
-    if (lhs->is_terms()) {
+  static Terms *make(Arena &A, ExprKind kind, Token *op, Expr *lhs,
+                     Expr *rhs) {
+    if (lhs->is_terms() && lhs->kind == kind) {
       lhs->as<Terms>()->append(op, rhs);
       return lhs->as<Terms>();
     }
 
-    auto x = new Terms(kind, op, lhs);
+    auto x = A.make<Terms>(A, kind, op, lhs);
 
     x->append(op, rhs);
 
     return x;
   }
 
-  ~Terms();
-
-  Terms(ExprKind kind, Token *op, Expr *base) : Expr(kind, op), base(base) {}
+  Terms(Arena &A, ExprKind kind, Token *op, Expr *base)
+      : Expr(kind, op), base(base), terms(A) {}
 };
 
 struct ExprStatement final : public Stmt {
   Expr *expr;
 
-  ~ExprStatement() {
-    if (expr) delete expr;
-  }
-
   ExprStatement(Expr *e) : Stmt(StmtKind::Expr, e->token), expr(e) {}
 };
 
@@ -158,18 +170,18 @@ struct Assign final : public Stmt {
   Expr *dest;
   Expr *source;
 
-  ~Assign();
+  // `dest: f32 = source`, None without an annotation.
+  TypeKind declared = TypeKind::None;
+  Token *type_tok = nullptr;
 
   Assign(Expr *dest, Expr *source, Token *op)
       : Stmt(StmtKind::Assign, op), dest(dest), source(source) {}
 };
 
 struct Scope final : public Stmt {
-  std::vector<Stmt *> codes;
+  ArenaVec<Stmt *> codes;
 
-  ~Scope();
-
-  Scope(Token *tok) : Stmt(StmtKind::Scope, tok) {}
+  Scope(Arena &A, Token *tok) : Stmt(StmtKind::Scope, tok), codes(A) {}
 };
 
 struct If final : public Stmt {
@@ -178,38 +190,32 @@ struct If final : public Stmt {
   If *elseif = nullptr;
   Scope *else_body = nullptr;
 
-  ~If();
-
   If(Token *tok) : Stmt(StmtKind::If, tok) {}
 };
 
 struct Func final : public Tree {
   Token *name_tok;
-  std::vector<Token *> args;
+  ArenaVec<Token *> args;
   Token *result_type;
   Scope *body = nullptr;
 
-  ~Func();
-
-  Func(Token *decl) : Tree(Kind::Func, decl) {}
+  Func(Arena &A, Token *decl) : Tree(Kind::Func, decl), args(A) {}
 };
 
+//
+// All nodes of a Program live in SourceFile::arena and are released at
+// once by SourceFile::release_program(); none of them has a destructor.
+//
 struct Program final {
-  std::vector<Func *> functions;
+  ArenaVec<Func *> functions;
 
-  std::vector<Stmt *> codes;
+  ArenaVec<Stmt *> codes;
 
   auto append_func(Func *f) -> Func * { return functions.emplace_back(f); }
 
   auto append_stmt(Stmt *s) -> Stmt * { return codes.emplace_back(s); }
 
-  Program() {}
-
-  ~Program() {
-    for (auto x : functions) delete x;
-
-    for (auto x : codes) delete x;
-  }
+  Program(Arena &A) : functions(A), codes(A) {}
 };
 
 }  // namespace CTRPluginFramework::lua::ast
\ No newline at end of file
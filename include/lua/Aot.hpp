@@ -0,0 +1,118 @@
+#pragma once
+
+#include <span>
+
+#include "EntryContext.hpp"
+#include "Interner.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// A script compiled ahead of time to C++ by tools/zlua2cpp:
+//
+//   make aot AOT_SCRIPTS=examples/coord-mod.zlua
+//
+// writes src/aot/coord-mod_zlua.cpp, defining lua::aot::coord_mod. It is
+// added in init_menu() with add_aot_entry() in place of add_entry().
+//
+// The generated code is the bc::Chunk the interpreter would run, one C++
+// statement per instruction, so it behaves the same: it stops at the
+// same statements under the Scheduler and resumes after wait() at the
+// same point.
+//
+struct AotScript {
+  // strings are interned when the entry is added, the others are bits.
+  struct Constant {
+    TypeKind kind;
+    u32 bits;
+    char const* str;
+  };
+
+  // the script it was made from; hot reload reads it from there.
+  char const* path;
+
+  VM::NativeBody run;
+
+  u32 body;
+  u8 num_regs;
+
+  std::span<Constant const> constants;
+
+  // slot -> name
+  std::span<char const* const> globals;
+
+  // natives the code calls, by name.
+  std::span<char const* const> natives;
+
+  // code stays empty, VM runs `run` instead.
+  auto make_chunk() const -> bc::Chunk* {
+    auto& interner = Interner::get();
+    auto chunk = new bc::Chunk();
+
+    chunk->body = this->body;
+    chunk->num_regs = this->num_regs;
+
+    for (auto&& k : this->constants) {
+      Object& obj = chunk->constants.emplace_back(k.kind);
+
+      if (k.kind == TypeKind::Str)
+        obj.v_str = interner.intern(k.str);
+      else
+        obj.v_u32 = k.bits;
+    }
+
+    for (auto&& name : this->globals)
+      chunk->globals.push_back(interner.intern(name));
+
+    return chunk;
+  }
+};
+
+namespace aot {
+
+// for the generated code. add_aot_entry() checked that it exists.
+inline auto native(char const* name) -> NativeFunction const& {
+  auto& reg = NativeRegistry::get();
+  return reg[reg.find(name)];
+}
+
+}  // namespace aot
+
+//
+// The EntryContext of an AotScript, ready at once: nothing is read or
+// compiled. nullptr if the plugin lacks a native the script calls.
+//
+inline auto make_aot_context(AotScript const& script, MenuEntry* e)
+    -> EntryContext* {
+  for (auto&& name : script.natives) {
+    if (NativeRegistry::get().find(name) == NativeRegistry::NOT_FOUND) {
+      OSD::Notify(std::string(script.path) + ": no native '" + name + "'");
+      return nullptr;
+    }
+  }
+
+  auto ctx = new EntryContext(script.path, e);
+
+  ctx->source->chunk = script.make_chunk();
+  ctx->source->globals = ctx->source->chunk->globals;
+  ctx->vm.aot = script.run;
+  ctx->publish(true);
+
+  return ctx;
+}
+
+// not added to CompileService, only the Scheduler needs it.
+inline auto add_aot_entry(PluginMenu& menu, AotScript const& script,
+                          MenuEntry* e) -> MenuEntry* {
+  auto ctx = make_aot_context(script, e);
+
+  if (!ctx) return nullptr;
+
+  e->SetArg(ctx);
+
+  menu.Append(e);
+
+  return e;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "types.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Bump pointer allocator. Objects made here are never destroyed one by
+// one: reset() or ~Arena() releases everything at once, so only
+// trivially destructible types may be placed in it.
+//
+class Arena {
+  struct alignas(std::max_align_t) Block {
+    Block* next;
+    size_t size;
+    size_t used;
+
+    auto data() -> u8* { return reinterpret_cast<u8*>(this + 1); }
+  };
+
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+  Block* head = nullptr;
+
+  size_t block_size;
+
+  auto new_block(size_t min_size) -> Block*;
+
+ public:
+  Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size(block_size) {}
+
+  Arena(Arena const&) = delete;
+
+  ~Arena() { this->reset(); }
+
+  auto alloc(size_t size, size_t align) -> void*;
+
+  template <typename T, typename... Args>
+  auto make(Args&&... args) -> T* {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena never runs destructors.");
+
+    return new (this->alloc(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+  }
+
+  // release all memory.
+  auto reset() -> void;
+};
+
+//
+// Growable array whose storage lives in an Arena.
+// Old storage is abandoned on growth and reclaimed by Arena::reset().
+//
+template <typename T>
+class ArenaVec {
+  static_assert(std::is_trivially_destructible_v<T>);
+
+  Arena* arena;
+
+  T* ptr = nullptr;
+  u32 count = 0;
+  u32 capacity = 0;
+
+  auto grow() -> void {
+    u32 cap = this->capacity ? this->capacity * 2 : 4;
+    T* p = static_cast<T*>(this->arena->alloc(sizeof(T) * cap, alignof(T)));
+
+    for (u32 i = 0; i < this->count; i++) new (p + i) T(this->ptr[i]);
+
+    this->ptr = p;
+    this->capacity = cap;
+  }
+
+ public:
+  using iterator = T*;
+
+  ArenaVec(Arena& arena) : arena(&arena) {}
+
+  auto begin() const -> T* { return ptr; }
+  auto end() const -> T* { return ptr + count; }
+
+  auto size() const -> size_t { return count; }
+  auto empty() const -> bool { return count == 0; }
+
+  auto operator[](size_t i) const -> T& { return ptr[i]; }
+
+  auto back() const -> T& { return ptr[count - 1]; }
+
+  template <typename... Args>
+  auto emplace_back(Args&&... args) -> T& {
+    if (this->count == this->capacity) this->grow();
+
+    return *new (this->ptr + this->count++) T(std::forward<Args>(args)...);
+  }
+
+  auto push_back(T const& x) -> void { this->emplace_back(x); }
+
+  auto erase(T* first, T* last) -> T* {
+    T* out = first;
+
+    for (T* p = last; p != this->end(); p++) *out++ = *p;
+
+    this->count -= last - first;
+
+    return first;
+  }
+
+  auto erase(T* it) -> T* { return this->erase(it, it + 1); }
+};
+
+}  // namespace CTRPluginFramework::lua
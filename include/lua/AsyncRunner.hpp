@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+
+#include "WorkerThread.hpp"
+#include "WriteQueue.hpp"
+
+namespace CTRPluginFramework::lua {
+
+struct EntryContext;
+
+//
+// Runs an EntryContext's script on its own thread, off the game thread.
+//
+// Consistency model:
+// - reads of game memory happen on the worker, at any point of a frame.
+// - writes go to `writes` and are applied by the game thread in sync(),
+//   so every write lands at the first frame boundary after it was made,
+//   in program order. A pass still running at a boundary has its writes
+//   so far applied there and the rest at the next one.
+// - a read does not see writes of its own pass that are still queued.
+// - build, hot reload and activation (EntryContext::prepare) run on the
+//   game thread while the worker is idle, and so does the report of a
+//   runtime error of the last pass.
+//
+// The worker is a WorkerThread, below the game thread's priority. If no
+// thread can be made the passes run in sync() instead, with the same
+// model.
+//
+// A Scheduler skips an entry while it is in this mode.
+//
+class AsyncRunner {
+  enum Phase : u32 {
+    Idle,
+    Run,
+  };
+
+  EntryContext* ctx;
+
+  std::atomic<u32> phase = Idle;
+  std::atomic<bool> stop = false;
+
+  WorkerThread worker;
+
+  auto work() -> void;
+
+ public:
+  WriteQueue writes;
+
+  AsyncRunner(EntryContext* ctx);
+
+  AsyncRunner(AsyncRunner const&) = delete;
+
+  ~AsyncRunner();
+
+  // game thread, once per frame: apply the queued writes, then start the
+  // next pass if the last one is done.
+  auto sync() -> void;
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+
+#include "Object.hpp"
+#include "ObjectOps.hpp"
+#include "Token.hpp"
+
+namespace CTRPluginFramework::lua::bc {
+
+//
+// Register based instruction set.
+//
+//   R[x]   register x of the current frame
+//   K[x]   constant x of the chunk
+//   G[x]   global slot x
+//   RK(x)  K[x - RK_CONST] if x >= RK_CONST, otherwise R[x]
+//
+enum class OpCode : u8 {
+  Nop,
+
+  LoadK,      // R[a] = K[bx]
+  Move,       // R[a] = R[b]
+  GetGlobal,  // R[a] = G[bx]
+  SetGlobal,  // G[bx] = R[a]
+
+  // R[a] = RK(b) op RK(c), in the same order as BinOp
+  Mul,
+  Div,
+  Mod,
+  Add,
+  Sub,
+  LShift,
+  RShift,
+  Less,
+  Greater,
+  Equal,
+  NotEqual,
+  BitAnd,
+  BitXor,
+  BitOr,
+
+  // R[a] = RK(b) op RK(c) with both operands proven to be of one kind,
+  // see ops::typed_index. One block of BinOps per ops::TYPED_KINDS.
+  Typed,
+  TypedEnd = Typed + ops::NUM_TYPED - 1,
+
+  Jmp,         // pc += sbx
+  JmpIfFalse,  // if !R[a].v_bool then pc += sbx
+
+  CallNative,  // R[a] = native[b](R[a+1] ... R[a+c])
+
+  Halt,
+};
+
+constexpr auto binop_of(OpCode op) -> BinOp {
+  return static_cast<BinOp>(static_cast<int>(op) -
+                            static_cast<int>(OpCode::Mul));
+}
+
+constexpr auto opcode_of(BinOp op) -> OpCode {
+  return static_cast<OpCode>(static_cast<int>(op) +
+                             static_cast<int>(OpCode::Mul));
+}
+
+static_assert(binop_of(OpCode::BitOr) == BinOp::BitOr);
+
+constexpr auto is_typed(OpCode op) -> bool {
+  return OpCode::Typed <= op && op <= OpCode::TypedEnd;
+}
+
+constexpr auto typed_index(OpCode op) -> size_t {
+  return static_cast<size_t>(op) - static_cast<size_t>(OpCode::Typed);
+}
+
+static_assert(static_cast<u32>(OpCode::Halt) < 0x80, "op is 7 bits.");
+
+static constexpr u8 RK_CONST = 0x80;
+static constexpr u8 MAX_REGS = RK_CONST;
+static constexpr int SBX_BIAS = 0x7FFF;
+
+//
+// op:7 | s:1 | a:8 | b:8 | c:8  (bx = b | c << 8)
+//
+// s marks the first instruction of a statement, where the VM may stop
+// when its step budget runs out.
+//
+struct Instruction {
+  static constexpr u32 STMT_FLAG = 0x80;
+
+  u32 raw;
+
+  auto op() const -> OpCode { return static_cast<OpCode>(raw & 0x7F); }
+  auto is_stmt() const -> bool { return raw & STMT_FLAG; }
+  auto a() const -> u8 { return (raw >> 8) & 0xFF; }
+  auto b() const -> u8 { return (raw >> 16) & 0xFF; }
+  auto c() const -> u8 { return (raw >> 24) & 0xFF; }
+  auto bx() const -> u16 { return raw >> 16; }
+  auto sbx() const -> int { return static_cast<int>(bx()) - SBX_BIAS; }
+
+  auto with_b(u8 b) const -> Instruction {
+    return {(raw & ~(0xFFu << 16)) | (u32)b << 16};
+  }
+
+  static auto abc(OpCode op, u8 a, u8 b = 0, u8 c = 0) -> Instruction {
+    return {static_cast<u32>(op) | (u32)a << 8 | (u32)b << 16 | (u32)c << 24};
+  }
+
+  static auto abx(OpCode op, u8 a, u16 bx) -> Instruction {
+    return {static_cast<u32>(op) | (u32)a << 8 | (u32)bx << 16};
+  }
+
+  static auto asbx(OpCode op, u8 a, int sbx) -> Instruction {
+    return abx(op, a, static_cast<u16>(sbx + SBX_BIAS));
+  }
+};
+
+static_assert(sizeof(Instruction) == 4);
+
+//
+// Compiled form of one ast::Program.
+//
+// code[0 .. body) is the prologue: load-time assignments, run once when
+// the entry is first enabled. code[body ..] runs every frame. Both parts
+// end with Halt.
+//
+struct Chunk {
+  std::vector<Instruction> code;
+  u32 body = 0;
+  std::vector<Object> constants;
+
+  // slot -> name
+  std::vector<StringID> globals;
+
+  u8 num_regs = 0;
+};
+
+}  // namespace CTRPluginFramework::lua::bc
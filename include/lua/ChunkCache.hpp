@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+
+#include "ByteCode.hpp"
+#include "SourceFile.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Compiled bc::Chunk stored next to the source as `<path>c` (.zluac).
+//
+// The file is position independent: names, string constants and native
+// functions are stored as indices into its own string table and bound
+// again on load. It is keyed by a hash of the source text and read back
+// in one File::Read.
+//
+class ChunkCache {
+  // bump when the format or the compiler output changes.
+  static constexpr u32 FORMAT_VERSION = 7;
+
+  static constexpr u32 MAGIC = 'Z' | 'L' << 8 | 'C' << 16 | '\0' << 24;
+
+  //
+  // Sections follow the header in this order, all u32 aligned:
+  //
+  //   code       u32 x code_count, CallNative b is an index in natives
+  //   constants  ConstEntry x const_count
+  //   globals    u32 x global_count, string index per slot
+  //   natives    NativeEntry x native_count
+  //   strings    u32 x (string_count + 1) offsets, then string_bytes
+  //
+  struct Header {
+    u32 magic;
+    u32 version;
+
+    u32 source_hash;
+    u32 source_size;
+
+    u32 body;
+    u32 num_regs;
+
+    u32 code_count;
+    u32 const_count;
+    u32 global_count;
+    u32 native_count;
+    u32 string_count;
+    u32 string_bytes;
+  };
+
+  struct ConstEntry {
+    u32 kind;   // TypeKind
+    u32 value;  // raw value, or a string index for Str
+  };
+
+  struct NativeEntry {
+    u32 name;  // string index
+    i32 arity;
+  };
+
+  SourceFile* source;
+
+  std::string path;
+
+ public:
+  ChunkCache(SourceFile* source)
+    : source(source),
+      path(source->path + "c")
+  {
+  }
+
+  // nullptr if there is no cache or it does not match the source.
+  auto load() -> bc::Chunk*;
+
+  auto store(bc::Chunk const& chunk) -> bool;
+};
+
+}  // namespace CTRPluginFramework::lua
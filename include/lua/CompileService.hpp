@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "EntryContext.hpp"
+#include "WorkerThread.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Builds registered entries ahead of their first activation on a pool
+// of WorkerThreads. Each EntryContext is published by its worker when
+// done; until then EntryContext::eval() leaves it alone.
+//
+// Workers share only the Interner and the Logger, which lock.
+//
+class CompileService {
+  std::vector<EntryContext*> queue;
+
+  // next index of queue to take
+  std::atomic<size_t> next = 0;
+
+  std::vector<WorkerThread> workers;
+
+  auto work() -> void;
+
+ public:
+  CompileService() = default;
+
+  CompileService(CompileService const&) = delete;
+
+  ~CompileService() { this->wait(); }
+
+  // entry made by add_entry(). must be called before start().
+  auto add(MenuEntry* e) -> void;
+
+  auto start(unsigned num_workers) -> void;
+
+  // one on the 3DS, where every WorkerThread goes to the same core
+  // first; one per hardware thread on the host. never 0.
+  static auto default_workers() -> unsigned;
+
+  // join the workers. every added entry is published after this.
+  auto wait() -> void;
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "AST.hpp"
+#include "ByteCode.hpp"
+#include "SourceFile.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// ast::Program --> bc::Chunk
+//
+class Compiler {
+  using ExprKind = ast::ExprKind;
+  using StmtKind = ast::StmtKind;
+  using OpCode = bc::OpCode;
+
+  SourceFile* source;
+
+  bc::Chunk* chunk = nullptr;
+
+  u8 reg_top = 0;
+
+  bool failed = false;
+
+  auto error(Token* tok, std::string const& msg) -> void;
+
+  auto emit(bc::Instruction i) -> size_t;
+
+  auto emit_jump(OpCode op, u8 a = 0) -> size_t;
+
+  auto patch_jump(size_t at) -> void;
+
+  auto alloc_reg() -> u8;
+
+  auto free_reg(u8 count = 1) -> void { reg_top -= count; }
+
+  auto add_constant(Object const& obj) -> u16;
+
+  auto find_prologue(ast::Program* prg) -> std::vector<bool>;
+
+  auto is_load_time(ast::Expr* expr, std::vector<bool> const& known) -> bool;
+
+  // marks the first instruction with Instruction::STMT_FLAG.
+  auto compile_stmt(ast::Stmt* stmt) -> void;
+
+  auto compile_stmt_body(ast::Stmt* stmt) -> void;
+
+  auto compile_if(ast::If* ifs) -> void;
+
+  auto compile_expr(ast::Expr* expr) -> u8;
+
+  auto compile_rk(ast::Expr* expr) -> u8;
+
+  auto compile_call(ast::CallFunc* cf) -> u8;
+
+  auto compile_terms(ast::Terms* terms) -> u8;
+
+ public:
+  Compiler(SourceFile* source) : source(source) {}
+
+  auto compile(ast::Program* prg) -> bc::Chunk*;
+};
+
+}  // namespace CTRPluginFramework::lua
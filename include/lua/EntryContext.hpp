@@ -1,77 +1,361 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include <CTRPluginFramework/Menu.hpp>
 
 #include "SourceFile.hpp"
+#include "Lexer.hpp"
 #include "Parser.hpp"
-#include "Eval.hpp"
+#include "Resolver.hpp"
+#include "Optimizer.hpp"
+#include "TypeInfer.hpp"
+#include "Compiler.hpp"
+#include "ChunkCache.hpp"
+#include "Interner.hpp"
+#include "VM.hpp"
+#include "AsyncRunner.hpp"
+#include "WorkerThread.hpp"
 #include "Logger.hpp"
 
 namespace CTRPluginFramework::lua {
 
 struct EntryContext {
-  SourceFile source;
-  ASTEvaluator evaluator;
+  enum class State : u8 {
+    None,      // not built, or the last build failed
+    Queued,    // a CompileService worker owns `source`
+    Ready,
+  };
+
+  // for a WorkerThread that runs build(): the parser recurses once per
+  // nesting level of the script.
+  static constexpr size_t BUILD_STACK_SIZE = 2 * WorkerThread::STACK_SIZE;
+
+  std::unique_ptr<SourceFile> source;
+  VM vm;
+
+  MenuEntry* entry;
+
+  // written by the worker with release, read by eval() with acquire.
+  std::atomic<State> state = State::None;
+
+  // message of the last failed build, written by the thread that built
+  // `source` before it publishes `state`.
+  std::string failure;
+
+  bool prologue_done = false;
+
+  //
+  // Hot reload. The reloader, a WorkerThread below the game thread,
+  // reads the file again and, if its size or hash changed, builds it
+  // into `next`; eval() swaps it in before the next frame. `next` and
+  // `reload_failure` are published by the release store of reload_done.
+  //
+  // Strings interned for a reload stay in the Interner, which never
+  // frees: each reload grows it by the names and literals the edit
+  // added, unchanged text maps to the same IDs. A long edit session
+  // grows it until the plugin restarts.
+  //
+  WorkerThread reloader;
+  std::atomic<bool> reload_done = false;
+  std::unique_ptr<SourceFile> next;
+
+  // message of the failed reload, empty if it did not fail.
+  std::string reload_failure;
+
+  // frames between checks, 0 = only on request_reload().
+  u32 reload_interval = 0;
+  u32 frames_since_check = 0;
+
+  auto is_ready() -> bool {
+    return this->state.load(std::memory_order_acquire) == State::Ready;
+  }
+
+  auto get_tokens() -> std::vector<Token>&
+    { return this->source->tokens; }
+
+  static auto parse(SourceFile& src) -> void {
+    src.program = src.parser->parse();
+
+    if (src.program && !Resolver(&src).resolve(src.program))
+      src.release_program();
+  }
+
+  static auto optimize(SourceFile& src) -> void {
+    auto removed = Optimizer(&src).optimize(src.program);
+
+    Logger::Emit(Utils::Format("%s: optimizer removed %zu nodes.",
+                               src.path.c_str(), removed));
+  }
+
+  // skip lex .. compile when the .zluac matches the source.
+  static auto load_cache(SourceFile& src) -> bool {
+    src.chunk = ChunkCache(&src).load();
+
+    if (!src.chunk) return false;
+
+    src.globals = src.chunk->globals;
+
+    return true;
+  }
+
+  static auto store_cache(SourceFile& src) -> void {
+    if (!ChunkCache(&src).store(*src.chunk))
+      Logger::Emit(src.path + ": failed to write the cache.");
+  }
+
+  // log msg and the errors of src, keep msg in `failure`. always false.
+  static auto fail(SourceFile& src, std::string& failure,
+                   std::string const& msg) -> bool {
+    failure = msg;
+
+    Logger::Emit(msg);
+
+    for (auto&& e : src.errors)
+      Logger::Emit(e->get_emit_message());
+
+    return false;
+  }
+
+  // lex .. compile src after read(), or load its cache.
+  // may run on a worker thread, which owns `failure`.
+  static auto build(SourceFile& src, std::string& failure) -> bool {
+    if (load_cache(src)) {
+      Logger::Emit(src.path + ": loaded from cache.");
+      return true;
+    }
+
+    if (!src.lexer->lex())
+      return fail(src, failure, src.path + ": failed to tokenize.");
+
+    parse(src);
+    if (!src.program)
+      return fail(src, failure, src.path + ": failed to parse.");
+
+    optimize(src);
+
+    if (!TypeInfer(&src).infer(src.program))
+      return fail(src, failure, src.path + ": type error.");
+
+    src.chunk = src.compiler->compile(src.program);
+    if (!src.chunk)
+      return fail(src, failure, src.path + ": failed to compile.");
+
+    store_cache(src);
+
+    return true;
+  }
+
+  auto build() -> bool {
+    if (!this->source->read())
+      return fail(*this->source, this->failure,
+                  "failed to read '" + this->source->path + "'");
+
+    return build(*this->source, this->failure);
+  }
+
+  // called by the CompileService worker that built source.
+  auto publish(bool ok) -> void {
+    this->state.store(ok ? State::Ready : State::None,
+                      std::memory_order_release);
+  }
 
-  auto is_parsed() -> bool {
-    return source.program != nullptr;
+  // check the file for changes off the frame path.
+  auto request_reload() -> void {
+    if (this->reloader.joinable()) return;
+
+    // no thread could be made: tried again at the next interval.
+    this->reload_done.store(false, std::memory_order_relaxed);
+    this->reloader.start<&EntryContext::reload_work>(this, BUILD_STACK_SIZE);
+  }
+
+  // on the reloader: touches only `src`, and `next` and `reload_failure`
+  // until reload_done.
+  auto reload_work() -> void {
+    auto src = std::make_unique<SourceFile>(this->source->path);
+
+    std::string failure;
+
+    if (!src->read())
+      fail(*src, failure, "failed to read '" + src->path + "'");
+    else if (src->data.size() != this->source->data.size() ||
+             src->hash != this->source->hash) {
+      if (build(*src, failure)) this->next = std::move(src);
+    }
+
+    this->reload_failure = std::move(failure);
+    this->reload_done.store(true, std::memory_order_release);
   }
 
-  auto get_token() -> Token*
-    { return this->source.token; }
+  // between frames: swap in the new program, keeping globals by name.
+  auto finish_reload() -> void {
+    this->reloader.join();
 
-  auto lex() -> void {
-    this->source.token = this->source.lexer->lex();
+    if (!this->reload_failure.empty()) OSD::Notify(this->reload_failure);
+
+    if (!this->next) return;
+
+    this->vm.remap_globals(this->source->chunk->globals,
+                           this->next->chunk->globals);
+
+    this->source = std::move(this->next);
+    this->prologue_done = false;
+
+    // the old code position means nothing in the new chunk, which is
+    // interpreted even if the old one was compiled ahead of time.
+    this->vm.cancel();
+    this->vm.aot = nullptr;
+
+    Logger::Emit(Utils::Format("%s: reloaded, %zu strings interned.",
+                               this->source->path.c_str(),
+                               Interner::get().size()));
+    OSD::Notify(this->source->path + ": reloaded.");
   }
 
-  auto parse() -> void {
-    this->source.program = this->source.parser->parse(this->get_token());
+  //
+  // Per-frame work before running: build on activation, hot reload.
+  // false if there is nothing to run.
+  //
+  auto prepare() -> bool {
+    // latched first: the edge is gone by the time a queued build is done.
+    if (this->entry->WasJustActivated()) this->vm.activated = true;
+
+    switch (this->state.load(std::memory_order_acquire)) {
+      case State::Ready:
+        break;
+
+      // still compiling in the background
+      case State::Queued:
+        return false;
+
+      // built on first activation, and again after it failed.
+      case State::None:
+        if (!this->entry->WasJustActivated()) return false;
+
+        this->source->reset();
+        this->prologue_done = false;
+        this->vm.cancel();
+        this->vm.aot = nullptr;
+
+        if (!this->build()) {
+          OSD::Notify(this->failure);
+          this->entry->Disable();
+          return false;
+        }
+
+        this->state.store(State::Ready, std::memory_order_relaxed);
+        break;
+    }
+
+    if (this->reload_done.load(std::memory_order_acquire) &&
+        this->reloader.joinable())
+      this->finish_reload();
+
+    if (this->reload_interval &&
+        ++this->frames_since_check >= this->reload_interval) {
+      this->frames_since_check = 0;
+      this->request_reload();
+    }
+
+    return true;
+  }
+
+  // step() on any thread: a runtime error is kept in vm.error.
+  auto run(u32& steps) -> VM::Status {
+    if (!this->prologue_done) {
+      this->vm.run_prologue(*this->source->chunk);
+      this->prologue_done = true;
+    }
+
+    return this->vm.run(*this->source->chunk, steps);
   }
 
+  // run at most `steps` statements on the game thread, see VM::run().
+  auto step(u32& steps) -> VM::Status {
+    auto status = this->run(steps);
+
+    this->report_error();
+
+    return status;
+  }
+
+  // show a runtime error of the last run and turn the entry off. false
+  // if there was none. game thread only, OSD and MenuEntry are not
+  // thread safe.
+  auto report_error() -> bool {
+    if (!this->vm.error) return false;
+
+    OSD::Notify(this->vm.error);
+    this->entry->Disable();
+
+    this->vm.error = nullptr;
+
+    return true;
+  }
+
+  // prepare and run without a budget.
   auto eval() -> void {
-    this->evaluator.eval(this->source.program);
+    u32 steps = VM::UNLIMITED;
+
+    if (this->prepare()) this->step(steps);
+  }
+
+  // run the script on a worker thread, see AsyncRunner.
+  std::unique_ptr<AsyncRunner> async;
+
+  auto set_async(bool on) -> void {
+    if (on == (this->async != nullptr)) return;
+
+    if (on) {
+      this->async = std::make_unique<AsyncRunner>(this);
+      this->vm.writes = &this->async->writes;
+    }
+    else {
+      this->async.reset();
+      this->vm.writes = nullptr;
+    }
+  }
+
+  // once per frame from the entry's callback, in either mode.
+  auto tick() -> void {
+    if (this->async)
+      this->async->sync();
+    else
+      this->eval();
   }
 
   EntryContext(std::string const& path, MenuEntry* e)
-    : source(path),
-      evaluator(&source, e)
+    : source(std::make_unique<SourceFile>(path)),
+      vm(e),
+      entry(e)
   {
   }
-};
 
-static auto add_entry(PluginMenu& menu, std::string const& path, MenuEntry* e) -> MenuEntry* {
+  ~EntryContext() {
+    // the worker uses the members below.
+    this->async.reset();
 
-  auto* ctx = new EntryContext(path, e);
-
-  if (!ctx->source.read()) {
-    OSD::Notify("failed to read '" + ctx->source.path + "'");
-    goto Fail;
+    this->reloader.join();
   }
+};
 
-  ctx->lex();
-  if (!ctx->get_token()) {
-    OSD::Notify(path + ": failed to tokenize.");
-    goto Fail;
-  }
+//
+// Only checks that the script exists. It is compiled when the entry is
+// first turned on, see EntryContext::eval().
+//
+inline auto add_entry(PluginMenu& menu, std::string const& path, MenuEntry* e) -> MenuEntry* {
 
-  ctx->parse();
-  if (!ctx->source.program) {
-    OSD::Notify(path + ": failed to parse.");
-    goto Fail;
+  if (File::Exists(path) != 1) {
+    OSD::Notify("failed to read '" + path + "'");
+    return nullptr;
   }
 
-  e->SetArg(ctx);
+  e->SetArg(new EntryContext(path, e));
 
   menu.Append(e);
 
   return e;
-
-Fail:
-  for(auto&&e:ctx->source.errors)
-    Logger::Emit(e->get_emit_message());
-
-  delete ctx;
-  return nullptr;
 }
 
 }
\ No newline at end of file
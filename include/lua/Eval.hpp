@@ -1,69 +1,43 @@
 #pragma once
 
-#include <algorithm>
-
 #include <CTRPluginFramework/Menu/MenuEntry.hpp>
 
 #include "AST.hpp"
 #include "Object.hpp"
+#include "Native.hpp"
+#include "ObjectOps.hpp"
+#include "SourceFile.hpp"
 
 namespace CTRPluginFramework::lua {
 
+//
+// The tree-walking evaluator the VM replaced, kept as the baseline of
+// bench/vm_ast.cpp. Not on any frame path.
+//
+// A tree walk cannot stop inside the program, so wait() and yield() end
+// the pass and the next eval() starts from the top.
+//
 class ASTEvaluator {
   using ExprKind = ast::ExprKind;
   using StmtKind = ast::StmtKind;
 
-  struct VarPairMap {
-    StringID  name;
-    Object*   object;
-
-    VarPairMap(StringID n, Object* o)
-      : name(n), object(o) { }
-  };
-
-  struct VarStorage {
-    std::vector<VarPairMap> storage;
-
-    auto find(StringID name) {
-      return std::find_if(storage.begin(), storage.end(), [name] (VarPairMap& map) -> bool {
-        return map.name == name;
-      });
-    }
-
-    auto contains(StringID name) -> bool {
-      return find(name) != storage.end();
-    }
-
-    auto get(StringID name) -> Object*& {
-      if (auto iter = find(name); iter != storage.end())
-        return iter->object;
-
-      return append(name).object;
-    }
-
-    auto append(StringID name, Object* obj = nullptr) -> VarPairMap& {
-      return storage.emplace_back(name, obj);
-    }
-  };
-
   SourceFile *source;
 
   MenuEntry *entry;
 
-  VarStorage globals;
+  // indexed by ast::Variable::slot
+  std::vector<Object> globals;
 
-  Object *get_global(StringID name)
-  {
-    if (!globals.contains(name)) {
-      return
-        globals.append(name, new Object(TypeKind::None))
-          .object;
-    }
+  // arguments of native calls, reused across calls.
+  std::vector<Object> stack;
 
-    return globals.get(name);
-  }
+  // a native asked to suspend, see above.
+  bool stopped = false;
 
  public:
+  // as VM::activated, cleared at the end of the pass.
+  bool activated = false;
+
   ASTEvaluator(SourceFile *source, MenuEntry *entry)
       : source(source), entry(entry)
   {
@@ -71,15 +45,28 @@ class ASTEvaluator {
 
   auto eval(ast::Program *prg) -> void
   {
+    if (globals.size() < source->globals.size())
+      globals.resize(source->globals.size());
+
+    stopped = false;
+
     try {
       for (auto &&x : prg->codes) {
+        if (stopped) return;
+
         eval_stmt(x);
       }
     }
+    catch (NativeError const &e) {
+      OSD::Notify(e.what);
+      entry->Disable();
+    }
     catch (...) {
       OSD::Notify("Runtime error!");
       entry->Disable();
     }
+
+    activated = false;
   }
 
   auto eval_stmt(ast::Stmt *tree) -> void
@@ -91,13 +78,21 @@ class ASTEvaluator {
 
         *dest = eval_expr(x->source);
 
+        // as Optimizer does for `x: f32 = 1`
+        if (ops::is_num(x->declared) && ops::is_num(dest->type.kind))
+          convert_object(*dest, x->declared);
+
         break;
       }
 
       case StmtKind::Scope: {
         auto x = tree->as<ast::Scope>();
 
-        for (auto &&y : x->codes) eval_stmt(y);
+        for (auto &&y : x->codes) {
+          if (stopped) break;
+
+          eval_stmt(y);
+        }
 
         break;
       }
@@ -134,54 +129,22 @@ class ASTEvaluator {
       case ExprKind::CallFunc: {
         auto cf = tree->as<ast::CallFunc>();
 
-        std::vector<Object> args;
+        auto base = stack.size();
 
         for (auto &&x : cf->args)
-          args.push_back(eval_expr(x));
+          stack.push_back(eval_expr(x));
 
-        Object result;
+        NativeCall call{stack.data() + base, static_cast<u8>(cf->args.size()),
+                        entry, activated};
 
-        if (cf->functor->is(ExprKind::Variable)) {
-          auto name = cf->functor->token->get_strview();
+        auto result =
+            NativeRegistry::invoke(NativeRegistry::get()[cf->native], call);
 
-          if (name == "readf") {
-            result.type = TypeKind::Float;
-            Process::ReadFloat(args[0].v_u32, result.v_float);
-            return result;
-          }
-          else if (name == "writef") {
-            u32 addr = args[0].v_u32;
-            float val = args[1].v_float;
-            result.type = TypeKind::Bool;
-            result.v_bool = Process::WriteFloat(addr, val);
-            return result;
-          }
-          else if (name == "is_pressed") {
-            u32 key = args[0].v_u32;
-            result.type = TypeKind::Bool;
-            result.v_bool = key != 0 & Controller::IsKeysDown(key);
-            return result;
-          }
-          else if (name == "check_addr") {
-            u32 addr = args[0].v_u32;
-            result.type = TypeKind::Bool;
-            result.v_bool = Process::CheckAddress(addr);
-            return result;
-          }
-          else if (name == "notify") {
-            std::string tmp;
-            for (auto &&x : args) tmp += x.to_str();
-            OSD::Notify(tmp);
-            return result;
-          }
-          else if (name == "on_enabled") {
-            result.type = TypeKind::Bool;
-            result.v_bool = this->entry->WasJustActivated();
-            return result;
-          }
-        }
+        stack.resize(base);
+
+        if (call.suspend) stopped = true;
 
-        return {};
+        return result;
       }
 
       default: {
@@ -190,31 +153,16 @@ class ASTEvaluator {
 
           auto val = eval_expr(expr->base);
 
-          for (auto &&[op, term] : expr->terms) {
-            auto x = eval_expr(term);
-            switch (expr->kind) {
-              case ExprKind::Add:
-                add_object(val, x);
-                break;
-              case ExprKind::Sub:
-                sub_object(val, x);
-                break;
-              case ExprKind::LShift:
-                left_shift_object(val, x);
-                break;
-              case ExprKind::BitAnd:
-                bit_and_object(val, x);
-                break;
-              case ExprKind::BitOr:
-                bit_or_object(val, x);
-                break;
-
-              default:
-                alert;
-                Process::ReturnToHomeMenu();
-            }
+          if (!ast::is_binop(expr->kind)) {
+            alert;
+            Process::ReturnToHomeMenu();
           }
 
+          auto op = ast::binop_of(expr->kind);
+
+          for (auto &&[_op, term] : expr->terms)
+            val = binary_op(op, val, eval_expr(term));
+
           return val;
         }
         break;
@@ -228,7 +176,7 @@ class ASTEvaluator {
   {
     switch (tree->kind) {
       case ExprKind::Variable:
-        return get_global(tree->as<ast::Variable>()->name);
+        return &globals[tree->as<ast::Variable>()->slot];
       default:
         alert;
         Logger::Emit(
@@ -237,81 +185,6 @@ class ASTEvaluator {
     }
     return nullptr;
   }
-
-  auto add_object(Object &a, Object &b) -> Object &
-  {
-    switch (a.type.kind) {
-      case TypeKind::I32:
-        a.v_i32 += b.v_i32;
-        break;
-
-      case TypeKind::U32:
-        a.v_u32 += b.v_u32;
-        break;
-
-      case TypeKind::Float:
-        a.v_float += b.v_float;
-        break;
-    }
-    return a;
-  }
-
-  auto sub_object(Object &a, Object &b) -> Object &
-  {
-    switch (a.type.kind) {
-      case TypeKind::I32:
-        a.v_i32 -= b.v_i32;
-        break;
-
-      case TypeKind::U32:
-        a.v_u32 -= b.v_u32;
-        break;
-
-      case TypeKind::Float:
-        a.v_float -= b.v_float;
-        break;
-    }
-    return a;
-  }
-
-  auto left_shift_object(Object &a, Object &b) -> Object &
-  {
-    switch (a.type.kind) {
-      case TypeKind::I32:
-        a.v_i32 <<= b.v_i32;
-        break;
-      case TypeKind::U32:
-        a.v_u32 <<= b.v_u32;
-        break;
-    }
-    return a;
-  }
-
-  auto bit_and_object(Object &a, Object &b) -> Object &
-  {
-    switch (a.type.kind) {
-      case TypeKind::I32:
-        a.v_i32 &= b.v_i32;
-        break;
-      case TypeKind::U32:
-        a.v_u32 &= b.v_u32;
-        break;
-    }
-    return a;
-  }
-
-  auto bit_or_object(Object &a, Object &b) -> Object &
-  {
-    switch (a.type.kind) {
-      case TypeKind::I32:
-        a.v_i32 |= b.v_i32;
-        break;
-      case TypeKind::U32:
-        a.v_u32 |= b.v_u32;
-        break;
-    }
-    return a;
-  }
 };
 
 }  // namespace CTRPluginFramework::lua
\ No newline at end of file
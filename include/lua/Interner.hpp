@@ -0,0 +1,64 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Token.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Process-wide string table. The same text gets the same StringID in
+// every SourceFile. Bytes live in an arena and are never freed, so the
+// views handed out stay valid for the life of the plugin.
+// Safe to use from the compile workers.
+//
+class Interner {
+  struct Slot {
+    u32 hash;
+    StringID id;
+  };
+
+  static constexpr StringID EMPTY = UINT32_MAX;
+  static constexpr size_t INITIAL_CAPACITY = 256;  // power of two
+
+  mutable std::mutex mutex;
+
+  Arena bytes;
+
+  // StringID -> text
+  std::vector<string_view> strings;
+
+  // open addressing, linear probing. size is a power of two.
+  std::vector<Slot> table;
+
+  Interner();
+
+  auto grow() -> void;
+
+  auto probe(string_view s, u32 hash) const -> size_t;
+
+ public:
+  static constexpr StringID NOT_FOUND = EMPTY;
+
+  static auto get() -> Interner&;
+
+  static auto hash(string_view s) -> u32;
+
+  auto intern(string_view s) -> StringID;
+
+  auto find(string_view s) const -> StringID;
+
+  auto view(StringID id) const -> string_view {
+    std::lock_guard lock(this->mutex);
+    return this->strings[id];
+  }
+
+  auto size() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->strings.size();
+  }
+};
+
+}  // namespace CTRPluginFramework::lua
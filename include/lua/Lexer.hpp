@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -13,7 +14,7 @@ class Lexer {
   template <typename K>
   using kind_str_map_t = std::pair<K, char const*>;
 
-  static inline const kind_str_map_t<TokOperators> g_op_str_table[] {
+  static constexpr kind_str_map_t<TokOperators> g_op_str_table[] {
     { TokOperators::_, nullptr },
     { TokOperators::LShiftAssign, "<<=" },
     { TokOperators::RShiftAssign, ">>=" },
@@ -48,7 +49,7 @@ class Lexer {
     { TokOperators::Mod,          "%" },
   };
 
-  static inline const kind_str_map_t<TokPunctuators> g_punct_str_table[] {
+  static constexpr kind_str_map_t<TokPunctuators> g_punct_str_table[] {
     { TokPunctuators::_,          nullptr },
     { TokPunctuators::Bracket,    nullptr },
     { TokPunctuators::Ellipsis,   "..." },
@@ -62,7 +63,7 @@ class Lexer {
     { TokPunctuators::Atmark,     "@" },
   };
 
-  static inline const kind_str_map_t<TokBrackets> g_bracket_str_table[] {
+  static constexpr kind_str_map_t<TokBrackets> g_bracket_str_table[] {
     { TokBrackets::_,       nullptr },
     { TokBrackets::Normal,  "()" },
     { TokBrackets::Scope,   "{}" },
@@ -70,7 +71,7 @@ class Lexer {
     { TokBrackets::Angle,   "<>" },
   };
 
-  static inline const kind_str_map_t<TokKeywords> g_kwd_str_table[] {
+  static constexpr kind_str_map_t<TokKeywords> g_kwd_str_table[] {
     { TokKeywords::_,         nullptr },
 
     { TokKeywords::True,      "true"  },
@@ -105,13 +106,66 @@ class Lexer {
     { TokKeywords::Import,    "import"    },
   };
 
-  SourceFile* source;
+  //
+  // Character classes, indexed by the unsigned byte value.
+  // '\0' is in no class, so scanning loops stop at the end of data.
+  //
+  enum CharClass : u8 {
+    CC_Space = 1 << 0,
+    CC_Digit = 1 << 1,
+    CC_HexDigit = 1 << 2,
+    CC_IdentHead = 1 << 3,
+    CC_Ident = 1 << 4,
+    CC_BinDigit = 1 << 5,
+  };
+
+  static const std::array<u8, 256> g_char_class;
+
+  static auto is(char c, u8 cc) -> bool
+    { return g_char_class[static_cast<u8>(c)] & cc; }
 
-  std::vector<string> strpool;
+  //
+  // Keywords by perfect hash of (first char, second char, last char,
+  // length). A new keyword that collides breaks the build.
+  //
+  static constexpr size_t KWD_HASH_SIZE = 64;
 
-  std::vector<std::u16string> str_literal_pool;
+  static constexpr auto kwd_hash(char const* s, size_t len) -> size_t {
+    return (static_cast<u8>(s[0]) + static_cast<u8>(s[len > 1]) +
+            static_cast<u8>(s[len - 1]) + len * 9) &
+           (KWD_HASH_SIZE - 1);
+  }
+
+  static const std::array<TokKeywords, KWD_HASH_SIZE> g_kwd_hash_table;
+
+  //
+  // Operators, punctuators and brackets grouped by first char, longest
+  // first. On a tie the table order above decides: punctuator, operator,
+  // then bracket.
+  //
+  struct PunctEntry {
+    char const* str = nullptr;
+    u8 len = 0;
+
+    TokOperators op = TokOperators::_;
+    TokPunctuators punct = TokPunctuators::_;
+    TokBrackets bracket = TokBrackets::_;
+    bool is_open = false;
+  };
+
+  struct PunctIndex {
+    std::array<PunctEntry, 64> entries{};
+
+    // range in entries for each first char
+    std::array<u8, 256> begin{};
+    std::array<u8, 256> count{};
+  };
+
+  static const PunctIndex g_punct_index;
+
+  SourceFile* source;
 
-  std::vector<std::pair<Token*, string_view>> str_literal_create_task;
+  std::vector<std::pair<TokenIndex, string_view>> str_literal_create_task;
 
   size_t position = 0;
 
@@ -134,11 +188,28 @@ class Lexer {
   auto is_end() -> bool
     { return this->position >= this->source->data.length(); }
 
+  // the NUL after data can be peeked at the end.
   auto peek() -> char
-    { return this->source->data[this->position]; }
+    { return *this->cur(); }
 
   auto pass_space() -> void
-    { while (!this->is_end() && std::isspace(this->peek())) this->next(); }
+    { while (is(this->peek(), CC_Space)) this->next(); }
+
+  // skip chars of class cc, which must not include '\n'.
+  auto skip(u8 cc) -> void {
+    size_t n = 0;
+
+    while (is(this->cur()[n], cc)) n++;
+
+    this->position += n;
+    this->column += n;
+  }
+
+  auto lex_number(Token* tok) -> void;
+
+  auto find_keyword(char const* s, size_t len) -> TokKeywords;
+
+  auto find_punct(char const* s) -> PunctEntry const*;
 
   void pass_comments();
   bool pass_comment();
@@ -152,7 +223,12 @@ class Lexer {
 
   bool consume_str(string_view);
 
-  char* cur() { return this->source->data.data() + this->position; }
+  char const* cur() { return this->source->data.data() + this->position; }
+
+  // valid until the next push().
+  auto push(TokenKind kind) -> Token* {
+    return &this->source->tokens.emplace_back(kind, this->source);
+  }
 
   void create_str_literals();
 
@@ -161,13 +237,8 @@ class Lexer {
 
   ~Lexer() {}
 
-  auto lex() -> Token*;
-
-  auto get_strview(StringID) -> string_view;
-
-  auto get_str_id(string_view) -> StringID;
-
-  auto get_str_id(char const* ptr, size_t len) -> StringID;
+  // fills SourceFile::tokens.
+  auto lex() -> bool;
 
   static auto get_view_of(TokOperators) -> string_view;
   static auto get_view_of(TokPunctuators) -> string_view;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include <CTRPluginFramework/System.hpp>
 #include <CTRPluginFramework/Utils.hpp>
@@ -13,6 +14,9 @@ class Logger {
   static inline std::unique_ptr<LineWriter> writer;
   static inline File* fp = nullptr;
 
+  // Emit() is called from the compile workers too.
+  static inline std::mutex mutex;
+
 public:
   static auto SetFile(File* F) -> void {
     fp = F;
@@ -27,12 +31,21 @@ public:
     return fp->GetName();
   }
 
+  // dropped before SetFile(), as on the host.
   static auto Emit(std::string const& text) -> void {
+    std::lock_guard lock(mutex);
+
+    if (!writer) return;
+
     *writer << text << LineWriter::endl();
-    Flush();
+    writer->Flush();
   }
 
   static auto Flush() -> void {
+    std::lock_guard lock(mutex);
+
+    if (!writer) return;
+
     writer->Flush();
   }
 };
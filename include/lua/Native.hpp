@@ -0,0 +1,97 @@
+#pragma once
+
+#include <initializer_list>
+#include <vector>
+
+#include <CTRPluginFramework/Menu/MenuEntry.hpp>
+
+#include "Object.hpp"
+#include "WriteQueue.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Arguments of one native call. `args` points into the caller's value
+// stack (VM registers or ASTEvaluator::stack), nothing is allocated.
+//
+struct NativeCall {
+  Object* args;
+  u8 argc;
+  MenuEntry* entry;
+
+  // the entry was just turned on. stays set until the script has run
+  // through once, even across wait().
+  bool activated;
+
+  // memory writes go here instead of the game when set.
+  WriteQueue* writes = nullptr;
+
+  // otherwise, write immediately instead of through WriteBuffer.
+  bool write_through = false;
+
+  // set by wait() / yield(): suspend the script for this many frames.
+  u32 suspend = 0;
+};
+
+//
+// Thrown by a native that cannot go on, e.g. wait(0). The VM stops the
+// script and shows `what`.
+//
+struct NativeError {
+  char const* what;
+};
+
+using NativeFunc = auto (*)(NativeCall&) -> Object;
+
+struct NativeFunction {
+  static constexpr int MAX_PARAMS = 4;
+
+  char const* name;
+  NativeFunc fn;
+
+  // -1 = variadic, arguments are passed as they are.
+  int arity;
+
+  // arguments are converted to these before the call.
+  TypeKind params[MAX_PARAMS];
+
+  // kind of every value fn returns, None if it varies.
+  TypeKind result;
+};
+
+class NativeRegistry {
+  std::vector<NativeFunction> functions;
+
+  NativeRegistry();
+
+ public:
+  static constexpr int NOT_FOUND = -1;
+  static constexpr size_t MAX_FUNCTIONS = 256;
+
+  static auto get() -> NativeRegistry&;
+
+  auto add(char const* name, NativeFunc fn,
+           std::initializer_list<TypeKind> params,
+           TypeKind result = TypeKind::None) -> u16;
+
+  auto add_variadic(char const* name, NativeFunc fn,
+                    TypeKind result = TypeKind::None) -> u16;
+
+  auto find(string_view name) const -> int;
+
+  auto size() const -> size_t { return functions.size(); }
+
+  auto data() const -> NativeFunction const* { return functions.data(); }
+
+  auto operator[](u16 index) const -> NativeFunction const& {
+    return functions[index];
+  }
+
+  // convert arguments to the declared parameter types, then call.
+  static auto invoke(NativeFunction const& F, NativeCall& call) -> Object;
+};
+
+// defined in Builtins.cpp
+auto register_builtins(NativeRegistry& reg) -> void;
+
+}  // namespace CTRPluginFramework::lua
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <type_traits>
+
+#include "Interner.hpp"
 #include "TypeInfo.hpp"
-#include "utf.hpp"
 
 namespace CTRPluginFramework::lua {
 
+//
+// A script value in one 8-byte word: the type and a 32-bit payload.
+//
+// Object owns nothing. A string is the StringID of its text in Interner,
+// which is never freed, so Objects are copied as plain bytes in VM
+// registers, globals and constants, and equal strings have equal ids.
+//
 struct Object {
   TypeInfo type;
 
@@ -13,7 +22,7 @@ struct Object {
     u32 v_u32;
     float v_float;
     bool v_bool;
-    std::u16string *v_str;
+    StringID v_str;
   };
 
   string to_str() const
@@ -28,18 +37,18 @@ struct Object {
       case TypeKind::Bool:
         return v_bool ? "true" : "false";
       case TypeKind::Str:
-        return utf::utf16_to_utf8(*v_str);
+        return string(Interner::get().view(v_str));
     }
     return "??";
   }
 
+  // the payload is zeroed by the initializer of v_i32.
   Object(TypeInfo type = TypeKind::None) : type(type)
   {
-    v_u32 = 0;
-    v_bool = 0;
   }
-
-  ~Object() {}
 };
 
+static_assert(sizeof(Object) == 8);
+static_assert(std::is_trivially_copyable_v<Object>);
+
 }  // namespace CTRPluginFramework::lua
\ No newline at end of file
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include "Object.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Convert `a` to `kind` in place.
+// I32 <-> U32 keep the bits, Float <-> integers convert the value.
+//
+inline auto convert_object(Object &a, TypeKind kind) -> Object &
+{
+  switch (kind) {
+    case TypeKind::I32:
+    case TypeKind::U32:
+      if (a.type.kind == TypeKind::Float)
+        a.v_i32 = static_cast<i32>(a.v_float);
+      else if (a.type.kind == TypeKind::Bool)
+        a.v_u32 = a.v_bool;
+      break;
+
+    case TypeKind::Float:
+      if (a.type.kind == TypeKind::I32)
+        a.v_float = static_cast<float>(a.v_i32);
+      else if (a.type.kind == TypeKind::U32)
+        a.v_float = static_cast<float>(a.v_u32);
+      break;
+
+    case TypeKind::Bool:
+      a.v_bool = a.v_u32 != 0;
+      break;
+
+    default:
+      return a;
+  }
+
+  a.type = kind;
+  return a;
+}
+
+//
+// Binary operators on Object, shared by ASTEvaluator, VM and Optimizer.
+//
+// Same order as ast::ExprKind::Mul .. BitOr and bc::OpCode::Mul .. BitOr.
+//
+enum class BinOp : u8 {
+  Mul,
+  Div,
+  Mod,
+  Add,
+  Sub,
+  LShift,
+  RShift,
+  Less,
+  Greater,
+  Equal,
+  NotEqual,
+  BitAnd,
+  BitXor,
+  BitOr,
+};
+
+namespace ops {
+
+constexpr size_t NUM_OPS = static_cast<size_t>(BinOp::BitOr) + 1;
+constexpr size_t NUM_KINDS = static_cast<size_t>(TypeKind::Str) + 1;
+
+constexpr auto is_int(TypeKind k) -> bool {
+  return k == TypeKind::I32 || k == TypeKind::U32;
+}
+
+constexpr auto is_num(TypeKind k) -> bool {
+  return is_int(k) || k == TypeKind::Float;
+}
+
+//
+// Kind both operands are converted to, None if `op` does not apply.
+//
+//   arithmetic, comparison  Float if either is, else U32 if either is,
+//                           else I32
+//   bitwise                 U32 if either is, else I32; integers only
+//   shift                   the left operand's; integers only
+//   == and !=               as arithmetic for numbers, else the same
+//                           kind on both sides (strings by StringID)
+//
+// None has no operator: None == None is true, and None equals no other
+// value. See kernel().
+//
+constexpr auto promote(BinOp op, TypeKind a, TypeKind b) -> TypeKind {
+  switch (op) {
+    case BinOp::LShift:
+    case BinOp::RShift:
+      return is_int(a) && is_int(b) ? a : TypeKind::None;
+
+    case BinOp::BitAnd:
+    case BinOp::BitXor:
+    case BinOp::BitOr:
+      if (!is_int(a) || !is_int(b)) return TypeKind::None;
+      break;
+
+    case BinOp::Equal:
+    case BinOp::NotEqual:
+      if (!is_num(a) || !is_num(b)) return a == b ? a : TypeKind::None;
+      break;
+
+    default:
+      if (!is_num(a) || !is_num(b)) return TypeKind::None;
+      break;
+  }
+
+  if (a == TypeKind::Float || b == TypeKind::Float) return TypeKind::Float;
+  if (a == TypeKind::U32 || b == TypeKind::U32) return TypeKind::U32;
+
+  return TypeKind::I32;
+}
+
+constexpr auto is_compare(BinOp op) -> bool {
+  return BinOp::Less <= op && op <= BinOp::NotEqual;
+}
+
+// kind of `a op b`, None if it gives None.
+constexpr auto result_kind(BinOp op, TypeKind a, TypeKind b) -> TypeKind {
+  if (op == BinOp::Equal || op == BinOp::NotEqual) return TypeKind::Bool;
+
+  TypeKind k = promote(op, a, b);
+
+  return is_compare(op) && k != TypeKind::None ? TypeKind::Bool : k;
+}
+
+// C++ type of the payload of kind K.
+template <TypeKind K>
+using repr_t = std::conditional_t<
+    K == TypeKind::I32, i32,
+    std::conditional_t<K == TypeKind::Float, float,
+                       std::conditional_t<K == TypeKind::Bool, bool, u32>>>;
+
+// payload of `x` (of kind From) converted to the repr of To.
+template <TypeKind From, TypeKind To>
+inline auto load(Object const& x) -> repr_t<To> {
+  if constexpr (From == TypeKind::I32)
+    return static_cast<repr_t<To>>(x.v_i32);
+  else if constexpr (From == TypeKind::Float)
+    return static_cast<repr_t<To>>(x.v_float);
+  else if constexpr (From == TypeKind::Bool)
+    return static_cast<repr_t<To>>(x.v_bool);
+  else
+    return static_cast<repr_t<To>>(x.v_u32);
+}
+
+template <TypeKind K>
+inline auto store(repr_t<K> v) -> Object {
+  Object x(K);
+
+  if constexpr (K == TypeKind::I32)
+    x.v_i32 = v;
+  else if constexpr (K == TypeKind::Float)
+    x.v_float = v;
+  else if constexpr (K == TypeKind::Bool)
+    x.v_bool = v;
+  else
+    x.v_u32 = v;
+
+  return x;
+}
+
+//
+// `op` on two values of the same type. Integers wrap, shift counts are
+// taken mod 32, and dividing by 0 gives 0.
+//
+template <BinOp Op, typename T>
+inline auto apply(T x, T y) {
+  constexpr bool I = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+  constexpr bool S = std::is_signed_v<T>;
+
+  // integer math in u32, so i32 overflow wraps instead of being UB.
+  auto u = [](T v) { return static_cast<u32>(v); };
+
+  if constexpr (Op == BinOp::Less)
+    return x < y;
+  else if constexpr (Op == BinOp::Greater)
+    return x > y;
+  else if constexpr (Op == BinOp::Equal)
+    return x == y;
+  else if constexpr (Op == BinOp::NotEqual)
+    return x != y;
+  else if constexpr (!I) {
+    if constexpr (Op == BinOp::Mul)
+      return x * y;
+    else if constexpr (Op == BinOp::Div)
+      return x / y;
+    else if constexpr (Op == BinOp::Mod)
+      return std::fmod(x, y);
+    else if constexpr (Op == BinOp::Add)
+      return x + y;
+    else
+      return x - y;
+  }
+  else if constexpr (Op == BinOp::Mul)
+    return static_cast<T>(u(x) * u(y));
+  else if constexpr (Op == BinOp::Div) {
+    if (y == 0) return T(0);
+
+    // INT_MIN / -1 overflows, -x is the same and wraps.
+    if (S && y == T(-1)) return static_cast<T>(0u - u(x));
+
+    return T(x / y);
+  }
+  else if constexpr (Op == BinOp::Mod)
+    return y == 0 || (S && y == T(-1)) ? T(0) : T(x % y);
+  else if constexpr (Op == BinOp::Add)
+    return static_cast<T>(u(x) + u(y));
+  else if constexpr (Op == BinOp::Sub)
+    return static_cast<T>(u(x) - u(y));
+  else if constexpr (Op == BinOp::LShift)
+    return static_cast<T>(u(x) << (u(y) & 31));
+  else if constexpr (Op == BinOp::RShift)
+    return static_cast<T>(x >> (u(y) & 31));
+  else if constexpr (Op == BinOp::BitAnd)
+    return static_cast<T>(x & y);
+  else if constexpr (Op == BinOp::BitXor)
+    return static_cast<T>(x ^ y);
+  else
+    return static_cast<T>(x | y);
+}
+
+//
+// One cell of the table: `a op b` for a of kind A and b of kind B.
+// Operators that don't apply give None; == and != still give a Bool,
+// equal only for None on both sides.
+//
+template <BinOp Op, TypeKind A, TypeKind B>
+auto kernel(Object const& a, Object const& b) -> Object {
+  constexpr TypeKind T = promote(Op, A, B);
+
+  if constexpr (T == TypeKind::None) {
+    constexpr bool same = A == TypeKind::None && B == TypeKind::None;
+
+    if constexpr (Op == BinOp::Equal)
+      return store<TypeKind::Bool>(same);
+    else if constexpr (Op == BinOp::NotEqual)
+      return store<TypeKind::Bool>(!same);
+    else
+      return {};
+  }
+  else {
+    auto r = apply<Op>(load<A, T>(a), load<B, T>(b));
+
+    if constexpr (is_compare(Op))
+      return store<TypeKind::Bool>(r);
+    else
+      return store<T>(r);
+  }
+}
+
+using Kernel = auto (*)(Object const&, Object const&) -> Object;
+
+template <size_t... I>
+constexpr auto make_kernels(std::index_sequence<I...>)
+    -> std::array<Kernel, sizeof...(I)> {
+  return {&kernel<static_cast<BinOp>(I / (NUM_KINDS * NUM_KINDS)),
+                  static_cast<TypeKind>(I / NUM_KINDS % NUM_KINDS),
+                  static_cast<TypeKind>(I % NUM_KINDS)>...};
+}
+
+// [op][lhs kind][rhs kind], flattened.
+inline constexpr auto g_kernels =
+    make_kernels(std::make_index_sequence<NUM_OPS * NUM_KINDS * NUM_KINDS>());
+
+//
+// Kinds with a block of unchecked kernels: the cell [op][K][K] of
+// g_kernels, called without looking at the operands' kinds.
+//
+constexpr TypeKind TYPED_KINDS[] = {TypeKind::I32, TypeKind::U32,
+                                    TypeKind::Float};
+
+constexpr size_t NUM_TYPED = std::size(TYPED_KINDS) * NUM_OPS;
+
+// index in g_typed_kernels, or NUM_TYPED if `op` does not apply to K.
+constexpr auto typed_index(BinOp op, TypeKind k) -> size_t {
+  for (size_t i = 0; i < std::size(TYPED_KINDS); i++)
+    if (TYPED_KINDS[i] == k && promote(op, k, k) == k)
+      return i * NUM_OPS + static_cast<size_t>(op);
+
+  return NUM_TYPED;
+}
+
+template <size_t... I>
+constexpr auto make_typed_kernels(std::index_sequence<I...>)
+    -> std::array<Kernel, sizeof...(I)> {
+  return {&kernel<static_cast<BinOp>(I % NUM_OPS), TYPED_KINDS[I / NUM_OPS],
+                  TYPED_KINDS[I / NUM_OPS]>...};
+}
+
+inline constexpr auto g_typed_kernels =
+    make_typed_kernels(std::make_index_sequence<NUM_TYPED>());
+
+}  // namespace ops
+
+inline auto binary_op(BinOp op, Object const& a, Object const& b) -> Object {
+  size_t index = (static_cast<size_t>(op) * ops::NUM_KINDS +
+                  static_cast<size_t>(a.type.kind)) *
+                     ops::NUM_KINDS +
+                 static_cast<size_t>(b.type.kind);
+
+  return ops::g_kernels[index](a, b);
+}
+
+}  // namespace CTRPluginFramework::lua
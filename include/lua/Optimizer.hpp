@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include "AST.hpp"
+#include "SlotUsage.hpp"
+#include "SourceFile.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Runs between Resolver and Compiler:
+//   - folds constant terms (`1 << 4` --> `16`)
+//   - replaces globals that are only ever assigned one constant, once,
+//     at the top level before any read, with that constant
+//   - removes branches whose condition is constant
+//   - converts numeric constants to the declared kind (`x: f32 = 1`)
+//
+class Optimizer {
+  using ExprKind = ast::ExprKind;
+  using StmtKind = ast::StmtKind;
+
+  SourceFile* source;
+
+  SlotUsage usage;
+
+  // constant that replaces reads of each slot, or nullptr
+  std::vector<ast::Value*> values;
+
+  bool changed = false;
+
+  auto fold_expr(ast::Expr*& expr) -> void;
+
+  auto fold_terms(ast::Terms* terms) -> ast::Expr*;
+
+  auto fold_stmt(ast::Stmt*& stmt) -> void;
+
+  auto fold_block(ArenaVec<ast::Stmt*>& codes) -> void;
+
+  auto propagate(ast::Program* prg) -> void;
+
+  static auto count_stmt(ast::Stmt* stmt) -> size_t;
+
+  static auto count_expr(ast::Expr* expr) -> size_t;
+
+ public:
+  Optimizer(SourceFile* source) : source(source) {}
+
+  // returns the number of removed nodes.
+  auto optimize(ast::Program* prg) -> size_t;
+};
+
+}  // namespace CTRPluginFramework::lua
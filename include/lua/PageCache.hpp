@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mutex>
+
+#include "types.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Results of Process::CheckAddress by 4 KB page, shared by every entry.
+//
+// The game's heap layout rarely changes, so a page stays known for
+// `interval` frames. A copy that fails on a page the cache thought was
+// mapped drops that page at once. Safe to use from AsyncRunner workers.
+//
+class PageCache {
+ public:
+  static constexpr u32 PAGE_SIZE = 0x1000;
+
+  // direct mapped, power of two.
+  static constexpr size_t SLOTS = 256;
+
+  static constexpr u32 DEFAULT_INTERVAL = 60;
+
+  struct Stats {
+    u32 hits = 0;
+    u32 queries = 0;  // CheckAddress calls
+    u32 faults = 0;   // copies that failed on a known page
+  };
+
+ private:
+  struct Page {
+    u32 page = 0;
+    u32 epoch = 0;  // valid while equal to PageCache::epoch
+
+    // bit `perm`: that permission mask was checked / was valid.
+    u8 known = 0;
+    u8 valid = 0;
+  };
+
+  mutable std::mutex mutex;
+
+  Page pages[SLOTS];
+
+  // 0 never matches, so zeroed pages start out unknown.
+  u32 epoch = 1;
+
+  u32 interval = DEFAULT_INTERVAL;
+  u32 frames = 0;
+
+  Stats stats;
+
+  PageCache() = default;
+
+  static auto slot_of(u32 page) -> size_t { return page & (SLOTS - 1); }
+
+  auto check_locked(u32 addr, u32 perm) -> bool;
+
+  // a copy failed in [addr, addr + size).
+  auto fault(u32 addr, u32 size) -> void;
+
+ public:
+  static auto get() -> PageCache&;
+
+  // perm is a mask of MEMPERM_READ / MEMPERM_WRITE, as CheckAddress.
+  auto check(u32 addr, u32 perm) -> bool {
+    std::lock_guard lock(this->mutex);
+    return this->check_locked(addr, perm);
+  }
+
+  // checked CopyMemory from / to game memory, may cross one page.
+  auto read(u32 addr, void* out, u32 size) -> bool;
+
+  auto write(u32 addr, void const* in, u32 size) -> bool;
+
+  // frames a page stays known, at least 1.
+  auto set_interval(u32 frames) -> void {
+    std::lock_guard lock(this->mutex);
+    this->interval = frames ? frames : 1;
+  }
+
+  // once per frame; forgets every page each `interval` frames.
+  auto new_frame() -> void;
+
+  auto get_stats() const -> Stats {
+    std::lock_guard lock(this->mutex);
+    return this->stats;
+  }
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -19,14 +19,26 @@ class Parser {
 
   SourceFile *source;
 
-  Token *cur;
+  TokenIndex pos = 0;
+
+  // == &source->tokens[pos]
+  Token *cur = nullptr;
 
  public:
-  Parser(SourceFile *source) : source(source), cur(source->token) {}
+  Parser(SourceFile *source) : source(source) {}
 
   bool is_end() const { return cur->is_eof(); }
 
-  void next() { this->cur = this->cur->next; }
+  void next() { this->cur = &this->source->tokens[++this->pos]; }
+
+  Token *prev() { return &this->source->tokens[this->pos - 1]; }
+
+  auto arena() -> Arena & { return this->source->arena; }
+
+  template <typename T, typename... Args>
+  auto make(Args &&...args) -> T * {
+    return this->arena().make<T>(std::forward<Args>(args)...);
+  }
 
   bool look(auto cond) { return cur->is(cond); }
 
@@ -38,7 +50,7 @@ class Parser {
       return nullptr;
     }
 
-    return next(), cur->prev;
+    return next(), prev();
   }
 
   bool eat_open_of(TokBrackets b) { return cur->is(b, true) && (next(), true); }
@@ -53,7 +65,7 @@ class Parser {
       return nullptr;
     }
 
-    return next(), cur->prev;
+    return next(), prev();
   }
 
   Token *expect_close_of(TokBrackets b) {
@@ -62,45 +74,67 @@ class Parser {
       return nullptr;
     }
 
-    return next(), cur->prev;
+    return next(), prev();
+  }
+
+  // optional `: i32` or `: f32` after a name. false if `:` is not
+  // followed by a type.
+  bool p_type_annot(TypeKind &type, Token *&type_tok) {
+    type = TypeKind::None;
+    type_tok = nullptr;
+
+    if (!eat(TokPunctuators::Colon)) return true;
+
+    type_tok = cur;
+
+    if (eat(Kwd::I32))
+      type = TypeKind::I32;
+    else if (eat(Kwd::F32))
+      type = TypeKind::Float;
+    else {
+      source->add_error(Error(cur, "expected a type (i32 or f32)."));
+      return false;
+    }
+
+    return true;
   }
 
   Expr *p_factor() {
     auto tok = cur;
 
     if (eat(Kwd::True)) {
-      auto obj = new Object(TypeKind::Bool);
+      auto obj = make<Object>(TypeKind::Bool);
       obj->v_bool = true;
-      return new ast::Value(tok, obj);
+      return make<ast::Value>(tok, obj);
     }
 
     if (eat(Kwd::False)) {
-      return new ast::Value(tok, new Object(TypeKind::Bool));
+      return make<ast::Value>(tok, make<Object>(TypeKind::Bool));
     }
 
     if (eat(TokenKind::Literal)) {
-      auto val = new ast::Value(tok);
+      auto val = make<ast::Value>(tok);
 
       Object *obj = nullptr;
 
       switch (tok->literal) {
         case TokenLiterals::I32:
-          obj = new Object(TypeKind::I32);
+          obj = make<Object>(TypeKind::I32);
           obj->v_i32 = tok->v_i32;
           break;
 
         case TokenLiterals::U32:
-          obj = new Object(TypeKind::U32);
+          obj = make<Object>(TypeKind::U32);
           obj->v_u32 = tok->v_u32;
           break;
 
         case TokenLiterals::Float:
-          obj = new Object(TypeKind::I32);
+          obj = make<Object>(TypeKind::Float);
           obj->v_float = tok->v_float;
           break;
 
         case TokenLiterals::String:
-          obj = new Object(TypeKind::Str);
+          obj = make<Object>(TypeKind::Str);
           obj->v_str = tok->v_str;
           break;
 
@@ -115,7 +149,7 @@ class Parser {
       return val;
     }
 
-    if (eat(TokenKind::Identifier)) return new ast::Variable(tok);
+    if (eat(TokenKind::Identifier)) return make<ast::Variable>(tok);
 
     Logger::Emit(
         Utils::Format("cur=%p,kind=%d,str=", cur, static_cast<int>(cur->kind)) +
@@ -129,7 +163,7 @@ class Parser {
     if (!x) return nullptr;
 
     if (auto B = cur; eat_open_of(TokBrackets::Normal)) {
-      auto cf = new ast::CallFunc(x, B);
+      auto cf = make<ast::CallFunc>(arena(), x, B);
 
       if (eat_close_of(TokBrackets::Normal)) return cf;
 
@@ -137,10 +171,10 @@ class Parser {
         if (auto arg = p_expr())
           cf->args.push_back(arg);
         else
-          return (delete cf), nullptr;
+          return nullptr;
       } while (eat(TokPunctuators::Comma));
 
-      if (!expect_close_of(TokBrackets::Normal)) return (delete cf), nullptr;
+      if (!expect_close_of(TokBrackets::Normal)) return nullptr;
 
       return cf;
     }
@@ -148,24 +182,50 @@ class Parser {
     return x;
   }
 
-  Expr *p_mul();
+  Expr *p_mul() {
+    auto x = p_primary();
+    if (!x) return nullptr;
+
+    while (!is_end()) {
+      auto op = cur;
+      if (eat(TokOperators::Mul)) {
+        if (auto y = p_primary())
+          x = ast::Terms::make(arena(), ast::ExprKind::Mul, op, x, y);
+        else
+          return nullptr;
+      } else if (eat(TokOperators::Div)) {
+        if (auto y = p_primary())
+          x = ast::Terms::make(arena(), ast::ExprKind::Div, op, x, y);
+        else
+          return nullptr;
+      } else if (eat(TokOperators::Mod)) {
+        if (auto y = p_primary())
+          x = ast::Terms::make(arena(), ast::ExprKind::Mod, op, x, y);
+        else
+          return nullptr;
+      } else
+        break;
+    }
+
+    return x;
+  }
 
   Expr *p_add() {
-    auto x = p_primary();
+    auto x = p_mul();
     if (!x) return nullptr;
 
     while (!is_end()) {
       auto op = cur;
       if (eat(TokOperators::Add)) {
-        if (auto y = p_primary())
-          x = ast::Terms::make(ast::ExprKind::Add, op, x, y);
+        if (auto y = p_mul())
+          x = ast::Terms::make(arena(), ast::ExprKind::Add, op, x, y);
         else
-          return (delete x), nullptr;
+          return nullptr;
       } else if (eat(TokOperators::Sub)) {
-        if (auto y = p_primary())
-          x = ast::Terms::make(ast::ExprKind::Sub, op, x, y);
+        if (auto y = p_mul())
+          x = ast::Terms::make(arena(), ast::ExprKind::Sub, op, x, y);
         else
-          return (delete x), nullptr;
+          return nullptr;
       } else
         break;
     }
@@ -181,14 +241,14 @@ class Parser {
       auto op = cur;
       if (eat(TokOperators::LShift)) {
         if (auto y = p_add())
-          x = ast::Terms::make(ast::ExprKind::LShift, op, x, y);
+          x = ast::Terms::make(arena(), ast::ExprKind::LShift, op, x, y);
         else
-          return (delete x), nullptr;
+          return nullptr;
       } else if (eat(TokOperators::RShift)) {
         if (auto y = p_add())
-          x = ast::Terms::make(ast::ExprKind::RShift, op, x, y);
+          x = ast::Terms::make(arena(), ast::ExprKind::RShift, op, x, y);
         else
-          return (delete x), nullptr;
+          return nullptr;
       } else
         break;
     }
@@ -196,21 +256,63 @@ class Parser {
     return x;
   }
 
-  Expr *p_compare();
+  Expr *p_compare() {
+    auto x = p_shift();
+    if (!x) return nullptr;
 
-  Expr *p_equality();
+    while (!is_end()) {
+      auto op = cur;
+      if (eat(TokOperators::Less)) {
+        if (auto y = p_shift())
+          x = ast::Terms::make(arena(), ast::ExprKind::Less, op, x, y);
+        else
+          return nullptr;
+      } else if (eat(TokOperators::Greater)) {
+        if (auto y = p_shift())
+          x = ast::Terms::make(arena(), ast::ExprKind::Greater, op, x, y);
+        else
+          return nullptr;
+      } else
+        break;
+    }
+
+    return x;
+  }
+
+  Expr *p_equality() {
+    auto x = p_compare();
+    if (!x) return nullptr;
+
+    while (!is_end()) {
+      auto op = cur;
+      if (eat(TokOperators::Equal)) {
+        if (auto y = p_compare())
+          x = ast::Terms::make(arena(), ast::ExprKind::Equal, op, x, y);
+        else
+          return nullptr;
+      } else if (eat(TokOperators::NotEqual)) {
+        if (auto y = p_compare())
+          x = ast::Terms::make(arena(), ast::ExprKind::NotEqual, op, x, y);
+        else
+          return nullptr;
+      } else
+        break;
+    }
+
+    return x;
+  }
 
   Expr *p_bit_and() {
-    auto x = p_shift();
+    auto x = p_equality();
     if (!x) return nullptr;
 
     while (!is_end()) {
       auto op = cur;
       if (eat(TokOperators::BitAnd)) {
-        if (auto y = p_shift())
-          x = ast::Terms::make(ast::ExprKind::BitAnd, op, x, y);
+        if (auto y = p_equality())
+          x = ast::Terms::make(arena(), ast::ExprKind::BitAnd, op, x, y);
         else
-          return (delete x), nullptr;
+          return nullptr;
       } else
         break;
     }
@@ -218,19 +320,35 @@ class Parser {
     return x;
   }
 
-  Expr *p_bit_xor();
+  Expr *p_bit_xor() {
+    auto x = p_bit_and();
+    if (!x) return nullptr;
+
+    while (!is_end()) {
+      auto op = cur;
+      if (eat(TokOperators::BitXor)) {
+        if (auto y = p_bit_and())
+          x = ast::Terms::make(arena(), ast::ExprKind::BitXor, op, x, y);
+        else
+          return nullptr;
+      } else
+        break;
+    }
+
+    return x;
+  }
 
   Expr *p_bit_or() {
-    auto x = p_bit_and();
+    auto x = p_bit_xor();
     if (!x) return nullptr;
 
     while (!is_end()) {
       auto op = cur;
       if (eat(TokOperators::BitOr)) {
-        if (auto y = p_bit_and())
-          x = ast::Terms::make(ast::ExprKind::BitOr, op, x, y);
+        if (auto y = p_bit_xor())
+          x = ast::Terms::make(arena(), ast::ExprKind::BitOr, op, x, y);
         else
-          return (delete x), nullptr;
+          return nullptr;
       } else
         break;
     }
@@ -245,7 +363,7 @@ class Parser {
   Expr *p_expr() { return p_bit_or(); }
 
   auto p_ifs_else(Token *elsetok) -> ast::Scope * {
-    auto body = new ast::Scope(elsetok);
+    auto body = make<ast::Scope>(arena(), elsetok);
 
     while (!is_end()) {
       if (eat(Kwd::End)) {
@@ -254,7 +372,6 @@ class Parser {
       if (auto x = p_stmt())
         body->codes.push_back(x);
       else {
-        delete body;
         return nullptr;
       }
     }
@@ -287,19 +404,17 @@ class Parser {
   auto p_ifs(Token *iftok) -> ast::If * {
     if (auto if_cond = p_expr()) {
       if (auto tok_Then = expect(Kwd::Then)) {
-        auto ifs = new ast::If(iftok);
+        auto ifs = make<ast::If>(iftok);
         ifs->cond = if_cond;
-        ifs->body = new ast::Scope(tok_Then);
+        ifs->body = make<ast::Scope>(arena(), tok_Then);
         if (p_ifs_body(ifs)) {
           return ifs;
         } else {
-          delete ifs;
           return nullptr;
         }
       } else {
         source->add_error(
-            Error(cur->prev, "expected 'then' after this token."));
-        delete if_cond;
+            Error(prev(), "expected 'then' after this token."));
       }
     } else {
       source->add_error(Error(iftok, "expected expression after this token."));
@@ -315,17 +430,29 @@ class Parser {
     }
 
     if (auto x = p_expr()) {
+      TypeKind type;
+      Token *type_tok;
+
+      if (!p_type_annot(type, type_tok)) return nullptr;
+
       if (auto t = cur; eat(TokOperators::Assign)) {
         if (auto src = p_expr()) {
-          return new ast::Assign(x, src, t);
+          auto a = make<ast::Assign>(x, src, t);
+          a->declared = type;
+          a->type_tok = type_tok;
+          return a;
         } else {
-          delete x;
           source->add_error(Error(t, "expected expression after this token."));
           return nullptr;
         }
       }
 
-      return new ast::ExprStatement(x);
+      if (type_tok) {
+        source->add_error(Error(type_tok, "expected '=' after this token."));
+        return nullptr;
+      }
+
+      return make<ast::ExprStatement>(x);
     } else {
       source->add_error(Error(cur, "expected statement or expression."));
       return nullptr;
@@ -358,10 +485,11 @@ class Parser {
     return nullptr;
   }
 
-  auto parse(Token *token) -> ast::Program * {
-    this->cur = token;
+  auto parse() -> ast::Program * {
+    this->pos = 0;
+    this->cur = &this->source->tokens[0];
 
-    auto prg = new ast::Program();
+    auto prg = make<ast::Program>(arena());
 
     while (!is_end()) {
       if (look(TokKeywords::Fn)) {
@@ -380,7 +508,7 @@ class Parser {
     return prg;
 
   __fail:
-    delete prg;
+    source->release_program();
     return nullptr;
   }
 };
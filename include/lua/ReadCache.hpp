@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mutex>
+
+#include "types.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Per-frame snapshot of game memory, shared by every entry.
+//
+// A read loads the whole aligned BLOCK around it with one CheckAddress and
+// one CopyMemory. Later reads of the same block in the same frame are
+// served from the copy, so `readf(a)` and `readf(a + 8)` cost one access.
+//
+// new_frame() drops every block; invalidate() drops the blocks a write
+// touched. Safe to use from AsyncRunner workers.
+//
+class ReadCache {
+ public:
+  // a block never crosses a page, so one CheckAddress covers it.
+  static constexpr u32 BLOCK = 64;
+
+  // direct mapped, power of two.
+  static constexpr size_t SLOTS = 64;
+
+  struct Stats {
+    u32 hits = 0;
+    u32 misses = 0;    // block loaded
+    u32 uncached = 0;  // crossed a block, or the address was invalid
+  };
+
+ private:
+  struct Block {
+    u32 base = 0;
+    u32 frame = 0;  // valid while equal to ReadCache::frame
+    u8 data[BLOCK];
+  };
+
+  mutable std::mutex mutex;
+
+  Block blocks[SLOTS];
+
+  // 0 never matches, so zeroed blocks start out invalid.
+  u32 frame = 1;
+
+  Stats stats;
+
+  ReadCache() = default;
+
+  static auto slot_of(u32 base) -> size_t {
+    return (base / BLOCK) & (SLOTS - 1);
+  }
+
+ public:
+  static auto get() -> ReadCache&;
+
+  // false if the address can't be read.
+  auto read(u32 addr, void* out, u32 size) -> bool;
+
+  auto read_float(u32 addr, float& out) -> bool {
+    return this->read(addr, &out, sizeof(out));
+  }
+
+  // after a write to game memory.
+  auto invalidate(u32 addr, u32 size) -> void;
+
+  // once per frame, before any entry runs.
+  auto new_frame() -> void;
+
+  auto get_stats() const -> Stats {
+    std::lock_guard lock(this->mutex);
+    return this->stats;
+  }
+
+  // hits / all reads, 0 before the first read.
+  auto hit_rate() const -> float;
+};
+
+}  // namespace CTRPluginFramework::lua
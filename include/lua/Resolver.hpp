@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "AST.hpp"
+#include "SourceFile.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Gives every variable a dense slot index and binds every call to a
+// native function, so evaluation never looks a name up at runtime.
+// Slots are recorded in SourceFile::globals.
+//
+class Resolver {
+  using ExprKind = ast::ExprKind;
+  using StmtKind = ast::StmtKind;
+
+  static constexpr int NO_SLOT = -1;
+
+  SourceFile* source;
+
+  // StringID -> slot (StringIDs are dense)
+  std::vector<int> slot_of;
+
+  bool failed = false;
+
+  auto get_slot(StringID name) -> int;
+
+  auto resolve_stmt(ast::Stmt* stmt) -> void;
+
+  auto resolve_expr(ast::Expr* expr) -> void;
+
+  auto bind_native(ast::CallFunc* cf) -> void;
+
+ public:
+  Resolver(SourceFile* source) : source(source) {}
+
+  auto resolve(ast::Program* prg) -> bool;
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+
+#include <CTRPluginFramework/System/Clock.hpp>
+#include <CTRPluginFramework/System/Time.hpp>
+
+#include "EntryContext.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Runs the scheduled entries once per frame, from PluginMenu::OnNewFrame,
+// within one time budget for all of them.
+//
+// Entries run by priority, highest first, each up to its own budget of
+// statements. An entry the frame budget skipped gains one priority per
+// frame until it runs, so a busy frame cannot starve it. The clock is
+// read every SLICE statements; once the frame budget is spent the
+// running entry stops at that point and the rest wait for the next
+// frame. Stopped entries resume where they were. A frame overruns its
+// budget by at most one slice.
+//
+// The entries' own callbacks must call EntryContext::prepare() instead
+// of eval(). An entry in async mode (EntryContext::set_async) is skipped
+// while it is: its AsyncRunner runs it on its own thread.
+//
+class Scheduler {
+ public:
+  static constexpr u32 SLICE = 16;
+  static constexpr u32 DEFAULT_BUDGET = 1024;
+
+  struct Task {
+    EntryContext* ctx;
+
+    u8 priority;
+
+    // statements per frame
+    u32 budget;
+
+    u32 runs = 0;      // frames that reached the end or a wait()
+    u32 overruns = 0;  // frames stopped by `budget`
+    u32 deferred = 0;  // frames stopped or skipped by the frame budget
+
+    // frames in a row skipped by the frame budget, added to priority.
+    u32 age = 0;
+
+    // longest time spent in one frame
+    Time worst{};
+  };
+
+ private:
+  std::vector<Task> tasks;
+
+  // tasks in this frame's order, kept to not allocate every frame.
+  std::vector<Task*> order;
+
+  Time frame_budget;
+
+  // frames that ran out of the frame budget
+  u32 late_frames = 0;
+
+ public:
+  Scheduler(Time frame_budget = Milliseconds(2))
+    : frame_budget(frame_budget)
+  {
+  }
+
+  // entry made by add_entry().
+  auto add(MenuEntry* e, u8 priority = 0, u32 budget = DEFAULT_BUDGET)
+      -> void;
+
+  auto run_frame() -> void;
+
+  auto get_tasks() const -> std::vector<Task> const& { return tasks; }
+
+  auto get_late_frames() const -> u32 { return late_frames; }
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "AST.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// How each global slot is used by a program.
+// Positions are indices in Program::codes.
+//
+class SlotUsage {
+  using ExprKind = ast::ExprKind;
+  using StmtKind = ast::StmtKind;
+
+  size_t cur_index = 0;
+
+  auto collect_stmt(ast::Stmt* stmt) -> void;
+
+  auto collect_expr(ast::Expr* expr) -> void;
+
+ public:
+  static constexpr size_t NEVER = SIZE_MAX;
+
+  struct Info {
+    size_t assign_count = 0;
+    ast::Assign* top_assign = nullptr;  // top-level assignment
+    size_t top_index = 0;
+    size_t first_read = NEVER;
+  };
+
+  std::vector<Info> slots;
+
+  auto collect(ast::Program* prg, size_t num_slots) -> void;
+
+  // assigned exactly once, at the top level, before any read.
+  auto is_single_store(u16 slot) const -> bool {
+    auto& S = slots[slot];
+    return S.assign_count == 1 && S.top_assign && S.first_read > S.top_index;
+  }
+
+  auto operator[](u16 slot) -> Info& { return slots[slot]; }
+};
+
+}  // namespace CTRPluginFramework::lua
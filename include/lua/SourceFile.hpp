@@ -1,32 +1,55 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <CTRPluginFramework/System/File.hpp>
 
 #include "Token.hpp"
 #include "ASTFwd.hpp"
+#include "Arena.hpp"
 #include "Errors.hpp"
 
 namespace CTRPluginFramework::lua {
 
 class Lexer;
 class Parser;
+class Compiler;
+
+namespace bc {
+struct Chunk;
+}
 
 struct SourceFile {
   std::string path;
-  std::string data;
+
+  // the whole file plus a NUL, read at once and never modified.
+  // tokens and string literals point into it.
+  std::unique_ptr<char[]> buffer;
+  string_view data;
+
+  // Interner::hash() of data, set by read().
+  u32 hash = 0;
 
   std::vector<SourceFile*> imports;
 
   std::vector<Error*> errors;
 
-  File file;
-
   Lexer* lexer;
   Parser* parser;
+  Compiler* compiler;
+
+  // all tokens of `data`, the last one is Eof.
+  // not modified after Lexer::lex(), so Token* into it stay valid.
+  std::vector<Token> tokens;
+
+  // owns every AST node and literal Object of `program`.
+  Arena arena;
 
-  Token* token;
   ast::Program* program;
+  bc::Chunk* chunk;
+
+  // slot -> name, filled by Resolver.
+  std::vector<StringID> globals;
 
   auto add_error(Error const& e) -> Error& {
     return *this->errors.emplace_back(new Error(e));
@@ -34,6 +57,14 @@ struct SourceFile {
 
   auto read() -> bool;
 
+  auto release_program() -> void {
+    this->program = nullptr;
+    this->arena.reset();
+  }
+
+  // back to the state before read(), to build again.
+  auto reset() -> void;
+
   auto get_line_range(size_t pos) -> std::pair<size_t, size_t>;
 
   auto length() -> size_t const { return this->data.length(); }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace CTRPluginFramework::lua {
+
+//
+// Bounded single-producer / single-consumer ring buffer. push() may only
+// be called from one thread and pop() from one other thread; neither
+// blocks nor locks.
+//
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N && (N & (N - 1)) == 0, "N must be a power of two.");
+
+  // written by the consumer
+  alignas(64) std::atomic<size_t> head = 0;
+
+  // written by the producer
+  alignas(64) std::atomic<size_t> tail = 0;
+
+  T items[N];
+
+ public:
+  // false if full.
+  auto push(T const& x) -> bool {
+    size_t t = this->tail.load(std::memory_order_relaxed);
+
+    if (t - this->head.load(std::memory_order_acquire) == N) return false;
+
+    this->items[t & (N - 1)] = x;
+    this->tail.store(t + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  // false if empty.
+  auto pop(T& out) -> bool {
+    size_t h = this->head.load(std::memory_order_relaxed);
+
+    if (h == this->tail.load(std::memory_order_acquire)) return false;
+
+    out = this->items[h & (N - 1)];
+    this->head.store(h + 1, std::memory_order_release);
+
+    return true;
+  }
+};
+
+}  // namespace CTRPluginFramework::lua
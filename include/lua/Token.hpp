@@ -4,7 +4,11 @@
 
 namespace CTRPluginFramework::lua {
 
-using StringID = size_t;
+// index in Interner, the same in every SourceFile.
+using StringID = u32;
+
+// position of a Token in SourceFile::tokens
+using TokenIndex = u32;
 
 struct SourceFile;
 class Lexer;
@@ -142,9 +146,6 @@ struct Token {
   TokBrackets bracket = TokBrackets::_;
   bool is_brac_open = false;
 
-  Token* prev = nullptr;
-  Token* next = nullptr;
-
   StringID str = 0;
   size_t length = 0;
 
@@ -168,25 +169,14 @@ struct Token {
       char16_t v_char_surrogate;
     };
 
-    std::u16string* v_str;  // string literal
-                            // (object has hold by Lexer class.)
+    StringID v_str;  // string literal, in Interner
   };
 
   static Token empty;
 
   Token(TokenKind kind = TokenKind::Unknown) : kind(kind) {}
 
-  Token(TokenKind kind, Token* prev, SourceFile* source)
-      : kind(kind), prev(prev), source(source) {
-    if (prev) prev->next = this;
-  }
-
-  Token(Token const&) = delete;
-  Token(Token&&) = delete;
-
-  ~Token() {
-    if (this->next) delete this->next;
-  }
+  Token(TokenKind kind, SourceFile* source) : kind(kind), source(source) {}
 
   Lexer* get_lexer();
 
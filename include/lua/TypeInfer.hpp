@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "AST.hpp"
+#include "SourceFile.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Runs between Optimizer and Compiler. Gives Expr::type to expressions
+// whose kind is proven, so the Compiler can emit typed operators.
+//
+// A global has a kind when every value stored to it has that kind. A
+// read is only proven where a store to it always ran first, so it never
+// sees the initial None: an earlier store in the same block or one
+// around it, or in every branch of an earlier if. `x: f32 = ...`
+// declares the kind: every value stored to x must be proven to be f32.
+//
+class TypeInfer {
+  using ExprKind = ast::ExprKind;
+  using StmtKind = ast::StmtKind;
+
+  // Unset: nothing stored yet, Mixed: more than one kind or unknown.
+  enum class State : u8 { Unset, Known, Mixed };
+
+  struct Type {
+    State state = State::Unset;
+    TypeKind kind = TypeKind::None;
+
+    bool operator==(Type const&) const = default;
+  };
+
+  struct Slot {
+    Type type;
+    TypeKind declared = TypeKind::None;
+    Token* declared_at = nullptr;
+  };
+
+  SourceFile* source;
+
+  std::vector<Slot> slots;
+
+  // slot was stored to on every path to the current statement.
+  std::vector<bool> assigned;
+
+  bool changed = false;
+  bool failed = false;
+
+  auto declare_stmt(ast::Stmt* stmt) -> void;
+
+  auto infer_stmt(ast::Stmt* stmt) -> void;
+
+  auto infer_expr(ast::Expr* expr) -> Type;
+
+  auto check_stmt(ast::Stmt* stmt) -> void;
+
+  auto store(u16 slot, Type type) -> void;
+
+  auto error(Token* tok, std::string const& msg) -> void;
+
+ public:
+  TypeInfer(SourceFile* source) : source(source) {}
+
+  auto infer(ast::Program* prg) -> bool;
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -13,6 +13,24 @@ enum class TypeKind : u8 {
   Str,
 };
 
+// as written in scripts and messages.
+constexpr auto type_name(TypeKind kind) -> char const* {
+  switch (kind) {
+    case TypeKind::I32:
+      return "i32";
+    case TypeKind::U32:
+      return "u32";
+    case TypeKind::Float:
+      return "f32";
+    case TypeKind::Bool:
+      return "bool";
+    case TypeKind::Str:
+      return "str";
+    default:
+      return "None";
+  }
+}
+
 struct __attribute__((__packed__)) TypeInfo {
   TypeKind kind;
 
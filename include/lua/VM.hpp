@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+
+#include <CTRPluginFramework/Menu/MenuEntry.hpp>
+
+#include "ByteCode.hpp"
+#include "Native.hpp"
+#include "SourceFile.hpp"
+#include "WriteQueue.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Runs a bc::Chunk. Globals and registers persist between frames.
+//
+class VM {
+ public:
+  enum class Status : u8 {
+    Done,       // reached the end of the body
+    Suspended,  // in wait() / yield()
+    Preempted,  // out of steps, continues on the next run()
+  };
+
+  static constexpr u32 UNLIMITED = UINT32_MAX;
+
+  //
+  // What a chunk compiled ahead of time (tools/zlua2cpp) sees of a run.
+  // The generated function starts at `pc`, counts `steps` and stops
+  // where exec() would, leaving the code position to resume at in `pc`.
+  //
+  struct Frame {
+    Object* R;
+    Object* G;
+    Object const* K;
+
+    // args and argc are set per call.
+    NativeCall call;
+
+    u32 pc;
+    u32& steps;
+
+    auto preempt(u32 at) -> Status {
+      this->steps = 0;
+      this->pc = at;
+      return Status::Preempted;
+    }
+
+    // after a call that set call.suspend.
+    auto suspend(u32 at) -> Status {
+      this->pc = at;
+      return Status::Suspended;
+    }
+
+    auto invoke(NativeFunction const& F, Object* args, u8 argc) -> Object {
+      this->call.args = args;
+      this->call.argc = argc;
+      return NativeRegistry::invoke(F, this->call);
+    }
+  };
+
+  using NativeBody = auto (*)(Frame& f) -> Status;
+
+ private:
+  MenuEntry* entry;
+
+  std::vector<Object> globals;
+
+  std::vector<Object> regs;
+
+  //
+  // A stopped script keeps its registers and resumes at `resume_pc`
+  // after `wait_frames` more calls to run(), 0 when it was preempted.
+  //
+  static constexpr u32 NOT_SUSPENDED = UINT32_MAX;
+
+  u32 resume_pc = NOT_SUSPENDED;
+  u32 wait_frames = 0;
+
+  // `steps` is the number of statements that may start.
+  auto exec(bc::Chunk const& chunk, u32 start, u32& steps) -> Status;
+
+  auto exec_aot(bc::Chunk const& chunk, u32 start, u32& steps) -> Status;
+
+  // a native or operator threw: stop, and keep `what` in `error`.
+  auto runtime_error(char const* what = "Runtime error!") -> void;
+
+ public:
+  VM(MenuEntry* entry) : entry(entry) {}
+
+  auto prepare(bc::Chunk const& chunk) -> void;
+
+  // globals are kept by slot; move them to the slots of a new chunk
+  // by name. names that are gone are dropped.
+  auto remap_globals(std::vector<StringID> const& from,
+                     std::vector<StringID> const& to) -> void;
+
+  // set when the entry was just turned on, until the body is done.
+  bool activated = false;
+
+  // a runtime error of the last run, not reported yet. set on the thread
+  // that ran the script, see EntryContext::report_error().
+  char const* error = nullptr;
+
+  // see NativeCall::writes
+  WriteQueue* writes = nullptr;
+
+  // see NativeCall::write_through
+  bool write_through = false;
+
+  // the chunk's code compiled ahead of time, run instead of chunk.code.
+  // see AotScript.
+  NativeBody aot = nullptr;
+
+  // run the prologue of chunk, once.
+  auto run_prologue(bc::Chunk const& chunk) -> void {
+    u32 steps = UNLIMITED;
+    exec(chunk, 0, steps);
+  }
+
+  // run the per-frame part of chunk, or resume it. at most `steps`
+  // statements start; the number left is written back.
+  auto run(bc::Chunk const& chunk, u32& steps) -> Status;
+
+  auto run(bc::Chunk const& chunk) -> Status {
+    u32 steps = UNLIMITED;
+    return run(chunk, steps);
+  }
+
+  auto is_suspended() const -> bool { return resume_pc != NOT_SUSPENDED; }
+
+  // drop a suspended run, e.g. when the chunk is replaced.
+  auto cancel() -> void { resume_pc = NOT_SUSPENDED; }
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifdef __3DS__
+#include <3ds.h>
+#else
+#include <thread>
+#endif
+
+#include "types.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// A thread for work off the game thread: AsyncRunner's passes, the
+// CompileService and hot reload.
+//
+// On the 3DS it is a libctru thread one priority below the thread that
+// starts it, on core 2 of a New 3DS, else on core 1, else on the
+// plugin's own core. On the host it is a std::thread.
+//
+class WorkerThread {
+#ifdef __3DS__
+  Thread thread = nullptr;
+#else
+  std::thread thread;
+#endif
+
+  auto start(void (*fn)(void*), void* arg, size_t stack_size) -> bool;
+
+ public:
+  static constexpr size_t STACK_SIZE = 0x8000;
+
+  WorkerThread() = default;
+
+  WorkerThread(WorkerThread&& other) noexcept;
+
+  WorkerThread& operator=(WorkerThread&&) = delete;
+
+  ~WorkerThread() { this->join(); }
+
+  // run (self->*Fn)(). false if no thread could be made.
+  template <auto Fn, class T>
+  auto start(T* self, size_t stack_size = STACK_SIZE) -> bool {
+    return this->start([](void* p) { (static_cast<T*>(p)->*Fn)(); }, self,
+                       stack_size);
+  }
+
+  auto joinable() const -> bool;
+
+  auto join() -> void;
+};
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "types.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Write-combining buffer for writef(), shared by every entry and flushed
+// once per frame after all of them ran.
+//
+// Writes to the same address are combined, the last one wins, so two
+// entries writing one address leave the value of the one that ran last.
+// Writes to adjacent addresses go out as one CopyMemory.
+// readf() sees the buffered value of an address before the flush.
+//
+// Entries whose VM has `write_through` set write immediately instead.
+//
+class WriteBuffer {
+ public:
+  // longest run written by one CopyMemory; never crosses more than one
+  // page boundary.
+  static constexpr u32 MAX_RUN = 64;
+
+  struct Stats {
+    u32 issued = 0;    // write() calls
+    u32 combined = 0;  // replaced a buffered write to the same address
+    u32 flushed = 0;   // CopyMemory calls made by flush()
+    u32 failed = 0;    // runs dropped on an invalid address
+  };
+
+ private:
+  struct Pending {
+    u32 addr;
+    u32 value;
+  };
+
+  mutable std::mutex mutex;
+
+  // sorted by addr, no two overlap.
+  std::vector<Pending> pending;
+
+  Stats stats;
+
+  WriteBuffer() = default;
+
+  auto flush_locked() -> void;
+
+ public:
+  static auto get() -> WriteBuffer&;
+
+  // 4 bytes at `addr`.
+  auto write(u32 addr, u32 value) -> void;
+
+  // the buffered value of `addr`, if any.
+  auto peek(u32 addr, u32& value) const -> bool;
+
+  // write everything out, once per frame.
+  auto flush() -> void {
+    std::lock_guard lock(this->mutex);
+    this->flush_locked();
+  }
+
+  auto get_stats() const -> Stats {
+    std::lock_guard lock(this->mutex);
+    return this->stats;
+  }
+};
+
+}  // namespace CTRPluginFramework::lua
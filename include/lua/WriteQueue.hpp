@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+
+#include "SpscQueue.hpp"
+#include "types.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// A write to game memory made by a script.
+//
+struct MemWrite {
+  enum class Kind : u8 {
+    U32,
+    Float,
+  };
+
+  u32 addr;
+  u32 value;  // bits of the float for Kind::Float
+  Kind kind;
+
+  auto apply() const -> bool;
+};
+
+//
+// Writes of a script running on a worker thread (AsyncRunner), applied
+// by the game thread at the next frame boundary, in program order.
+//
+class WriteQueue {
+  static constexpr size_t CAPACITY = 256;
+
+  SpscQueue<MemWrite, CAPACITY> queue;
+
+  std::atomic<bool> closed = false;
+
+ public:
+  // producer. waits for the consumer while full, drops after close().
+  auto push(MemWrite const& w) -> void;
+
+  // consumer. applies everything queued so far, returns the count.
+  auto drain() -> size_t;
+
+  // stop push() from waiting.
+  auto close() -> void { closed.store(true); }
+};
+
+}  // namespace CTRPluginFramework::lua
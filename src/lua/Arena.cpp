@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "lua/Arena.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto Arena::new_block(size_t min_size) -> Block* {
+  size_t size = std::max(this->block_size, min_size);
+
+  auto block = static_cast<Block*>(std::malloc(sizeof(Block) + size));
+
+  if (!block) return nullptr;
+
+  block->next = this->head;
+  block->size = size;
+  block->used = 0;
+
+  return this->head = block;
+}
+
+auto Arena::alloc(size_t size, size_t align) -> void* {
+  if (auto b = this->head) {
+    size_t offs = (b->used + align - 1) & ~(align - 1);
+
+    if (offs + size <= b->size) {
+      b->used = offs + size;
+      return b->data() + offs;
+    }
+  }
+
+  // block data is aligned to max_align_t.
+  auto b = this->new_block(size);
+
+  // out of memory: nothing to unwind to, and `make test` has no exceptions.
+  if (!b) std::abort();
+
+  b->used = size;
+
+  return b->data();
+}
+
+auto Arena::reset() -> void {
+  while (auto b = this->head) {
+    this->head = b->next;
+    std::free(b);
+  }
+}
+
+}  // namespace CTRPluginFramework::lua
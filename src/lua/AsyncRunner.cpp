@@ -0,0 +1,62 @@
+#include "CTRPluginFramework.hpp"
+
+#include "lua/AsyncRunner.hpp"
+#include "lua/EntryContext.hpp"
+
+namespace CTRPluginFramework::lua {
+
+AsyncRunner::AsyncRunner(EntryContext* ctx) : ctx(ctx) {
+  // after every member is constructed
+  this->worker.start<&AsyncRunner::work>(this);
+}
+
+AsyncRunner::~AsyncRunner() {
+  this->stop.store(true);
+  this->writes.close();
+
+  this->phase.store(Run);
+  this->phase.notify_one();
+
+  this->worker.join();
+
+  this->writes.drain();
+}
+
+auto AsyncRunner::work() -> void {
+  while (!this->stop.load()) {
+    this->phase.wait(Idle);
+
+    if (this->stop.load()) break;
+
+    u32 steps = VM::UNLIMITED;
+
+    this->ctx->run(steps);
+
+    this->phase.store(Idle);
+  }
+}
+
+auto AsyncRunner::sync() -> void {
+  this->writes.drain();
+
+  // still in the last pass
+  if (this->phase.load() != Idle) return;
+
+  // the last pass failed, the entry is off now.
+  if (this->ctx->report_error()) return;
+
+  if (!this->ctx->prepare()) return;
+
+  // no thread could be made: the pass runs here.
+  if (!this->worker.joinable()) {
+    u32 steps = VM::UNLIMITED;
+
+    this->ctx->step(steps);
+    return;
+  }
+
+  this->phase.store(Run);
+  this->phase.notify_one();
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,104 @@
+#include <limits>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/Native.hpp"
+#include "lua/PageCache.hpp"
+#include "lua/ReadCache.hpp"
+#include "lua/WriteBuffer.hpp"
+
+namespace CTRPluginFramework::lua {
+
+namespace {
+
+// NaN if the address cannot be read, `x != x` in the script.
+auto readf(NativeCall& call) -> Object {
+  Object result(TypeKind::Float);
+
+  // a write still in the buffer is newer than the game's memory.
+  if (!WriteBuffer::get().peek(call.args[0].v_u32, result.v_u32) &&
+      !ReadCache::get().read_float(call.args[0].v_u32, result.v_float))
+    result.v_float = std::numeric_limits<float>::quiet_NaN();
+
+  return result;
+}
+
+// false if the address cannot be written, then nothing is written.
+auto writef(NativeCall& call) -> Object {
+  Object result(TypeKind::Bool);
+
+  if (call.write_through) {
+    result.v_bool = PageCache::get().write(call.args[0].v_u32,
+                                           &call.args[1].v_float, sizeof(float));
+
+    ReadCache::get().invalidate(call.args[0].v_u32, sizeof(float));
+  }
+  // applied later: checked now, the page stays valid for the frame.
+  else if (PageCache::get().check(call.args[0].v_u32, MEMPERM_WRITE)) {
+    if (call.writes)
+      call.writes->push({call.args[0].v_u32, call.args[1].v_u32,
+                         MemWrite::Kind::Float});
+    else
+      WriteBuffer::get().write(call.args[0].v_u32, call.args[1].v_u32);
+
+    result.v_bool = true;
+  }
+
+  return result;
+}
+
+auto is_pressed(NativeCall& call) -> Object {
+  u32 key = call.args[0].v_u32;
+  Object result(TypeKind::Bool);
+  result.v_bool = key != 0 && Controller::IsKeysDown(key);
+  return result;
+}
+
+auto check_addr(NativeCall& call) -> Object {
+  Object result(TypeKind::Bool);
+  result.v_bool = PageCache::get().check(call.args[0].v_u32,
+                                         MEMPERM_READ | MEMPERM_WRITE);
+  return result;
+}
+
+auto notify(NativeCall& call) -> Object {
+  std::string tmp;
+  for (u8 i = 0; i < call.argc; i++) tmp += call.args[i].to_str();
+  OSD::Notify(tmp);
+  return {};
+}
+
+auto on_enabled(NativeCall& call) -> Object {
+  Object result(TypeKind::Bool);
+  result.v_bool = call.activated;
+  return result;
+}
+
+// resume after `frames` frames, wait(1) is the same as yield().
+auto wait(NativeCall& call) -> Object {
+  if (call.args[0].v_i32 <= 0) throw NativeError{"wait: frames must be > 0"};
+
+  call.suspend = call.args[0].v_u32;
+  return {};
+}
+
+// resume on the next frame.
+auto yield(NativeCall& call) -> Object {
+  call.suspend = 1;
+  return {};
+}
+
+}  // namespace
+
+auto register_builtins(NativeRegistry& reg) -> void {
+  reg.add("readf", readf, {TypeKind::U32}, TypeKind::Float);
+  reg.add("writef", writef, {TypeKind::U32, TypeKind::Float}, TypeKind::Bool);
+  reg.add("is_pressed", is_pressed, {TypeKind::U32}, TypeKind::Bool);
+  reg.add("check_addr", check_addr, {TypeKind::U32}, TypeKind::Bool);
+  reg.add_variadic("notify", notify);
+  reg.add("on_enabled", on_enabled, {}, TypeKind::Bool);
+  reg.add("wait", wait, {TypeKind::I32});
+  reg.add("yield", yield, {});
+}
+
+}  // namespace CTRPluginFramework::lua
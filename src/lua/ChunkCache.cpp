@@ -0,0 +1,300 @@
+#include <cstring>
+#include <memory>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/ChunkCache.hpp"
+#include "lua/Interner.hpp"
+#include "lua/Native.hpp"
+
+namespace CTRPluginFramework::lua {
+
+using bc::Instruction;
+using bc::OpCode;
+
+namespace {
+
+struct Reader {
+  u8 const* ptr;
+  u8 const* end;
+
+  // false if the file is too short.
+  template <typename T>
+  auto read(T* out, size_t count) -> bool {
+    size_t size = sizeof(T) * count;
+
+    if (static_cast<size_t>(this->end - this->ptr) < size) return false;
+
+    std::memcpy(out, this->ptr, size);
+    this->ptr += size;
+
+    return true;
+  }
+};
+
+struct Writer {
+  std::vector<u8> buf;
+
+  template <typename T>
+  auto write(T const* p, size_t count) -> void {
+    auto b = reinterpret_cast<u8 const*>(p);
+    this->buf.insert(this->buf.end(), b, b + sizeof(T) * count);
+  }
+};
+
+}  // namespace
+
+auto ChunkCache::load() -> bc::Chunk* {
+  File file(this->path, File::READ);
+
+  if (!file.IsOpen()) return nullptr;
+
+  u64 size = file.GetSize();
+
+  if (size < sizeof(Header)) return nullptr;
+
+  auto buf = std::unique_ptr<u8[]>(new u8[size]);
+
+  if (file.Read(buf.get(), size) != 0) return nullptr;
+
+  Reader r{buf.get(), buf.get() + size};
+  Header h;
+
+  r.read(&h, 1);
+
+  string_view data = this->source->data;
+
+  if (h.magic != MAGIC || h.version != FORMAT_VERSION ||
+      h.source_size != data.size() || h.source_hash != this->source->hash)
+    return nullptr;
+
+  auto chunk = std::make_unique<bc::Chunk>();
+
+  std::vector<ConstEntry> consts(h.const_count);
+  std::vector<u32> globals(h.global_count);
+  std::vector<NativeEntry> natives(h.native_count);
+  std::vector<u32> offsets(h.string_count + 1);
+
+  chunk->code.resize(h.code_count);
+
+  if (!r.read(chunk->code.data(), h.code_count) ||
+      !r.read(consts.data(), h.const_count) ||
+      !r.read(globals.data(), h.global_count) ||
+      !r.read(natives.data(), h.native_count) ||
+      !r.read(offsets.data(), h.string_count + 1) ||
+      static_cast<size_t>(r.end - r.ptr) < h.string_bytes)
+    return nullptr;
+
+  auto get_string = [&](u32 index, string_view& out) -> bool {
+    if (index >= h.string_count || offsets[index] > offsets[index + 1] ||
+        offsets[index + 1] > h.string_bytes)
+      return false;
+
+    out = string_view(reinterpret_cast<char const*>(r.ptr) + offsets[index],
+                      offsets[index + 1] - offsets[index]);
+
+    return true;
+  };
+
+  auto& code = chunk->code;
+
+  if (h.body == 0 || h.body > code.size() || h.num_regs > bc::MAX_REGS ||
+      code[h.body - 1].op() != OpCode::Halt ||
+      code.back().op() != OpCode::Halt)
+    return nullptr;
+
+  auto is_reg = [&](u32 x) { return x < h.num_regs; };
+
+  auto is_rk = [&](u32 x) {
+    return x >= bc::RK_CONST ? x - bc::RK_CONST < h.const_count
+                             : is_reg(x);
+  };
+
+  // every operand in range, every jump inside its own part: the VM does
+  // not check them again.
+  for (size_t at = 0; at < code.size(); at++) {
+    auto i = code[at];
+    auto op = i.op();
+
+    bool ok;
+
+    switch (op) {
+      case OpCode::Nop:
+      case OpCode::Halt:
+        ok = true;
+        break;
+
+      case OpCode::LoadK:
+        ok = is_reg(i.a()) && i.bx() < h.const_count;
+        break;
+
+      case OpCode::Move:
+        ok = is_reg(i.a()) && is_reg(i.b());
+        break;
+
+      case OpCode::GetGlobal:
+      case OpCode::SetGlobal:
+        ok = is_reg(i.a()) && i.bx() < h.global_count;
+        break;
+
+      case OpCode::Jmp:
+      case OpCode::JmpIfFalse: {
+        bool in_body = at >= h.body;
+        i64 to = static_cast<i64>(at) + 1 + i.sbx();
+
+        ok = (op == OpCode::Jmp || is_reg(i.a())) &&
+             to >= (in_body ? h.body : 0) &&
+             to < static_cast<i64>(in_body ? code.size() : h.body);
+        break;
+      }
+
+      case OpCode::CallNative:
+        ok = i.b() < natives.size() && is_reg(i.a() + i.c()) &&
+             (natives[i.b()].arity < 0 || natives[i.b()].arity == i.c());
+        break;
+
+      default:
+        ok = ((OpCode::Mul <= op && op <= OpCode::BitOr) || bc::is_typed(op)) &&
+             is_reg(i.a()) && is_rk(i.b()) && is_rk(i.c());
+        break;
+    }
+
+    if (!ok) return nullptr;
+  }
+
+  chunk->body = h.body;
+  chunk->num_regs = h.num_regs;
+
+  string_view s;
+
+  // slot names
+  for (auto&& x : globals) {
+    if (!get_string(x, s)) return nullptr;
+
+    chunk->globals.push_back(Interner::get().intern(s));
+  }
+
+  // bind natives again by name, they may have moved in the registry.
+  auto& reg = NativeRegistry::get();
+
+  std::vector<u8> native_index(natives.size());
+
+  for (size_t i = 0; i < natives.size(); i++) {
+    if (!get_string(natives[i].name, s)) return nullptr;
+
+    int index = reg.find(s);
+
+    if (index == NativeRegistry::NOT_FOUND || reg[index].arity != natives[i].arity)
+      return nullptr;
+
+    native_index[i] = index;
+  }
+
+  for (auto&& i : code)
+    if (i.op() == OpCode::CallNative) i = i.with_b(native_index[i.b()]);
+
+  for (auto&& x : consts) {
+    if (x.kind > static_cast<u32>(TypeKind::Str)) return nullptr;
+
+    Object& obj = chunk->constants.emplace_back(static_cast<TypeKind>(x.kind));
+
+    if (obj.type.kind == TypeKind::Str) {
+      if (!get_string(x.value, s)) return nullptr;
+
+      obj.v_str = Interner::get().intern(s);
+    }
+    else
+      obj.v_u32 = x.value;
+  }
+
+  return chunk.release();
+}
+
+auto ChunkCache::store(bc::Chunk const& chunk) -> bool {
+  auto& reg = NativeRegistry::get();
+
+  std::vector<std::string> strings;
+
+  auto string_index = [&](string_view s) -> u32 {
+    for (size_t i = 0; i < strings.size(); i++)
+      if (strings[i] == s) return i;
+
+    strings.emplace_back(s);
+
+    return strings.size() - 1;
+  };
+
+  // registry index -> index in natives
+  std::vector<int> native_index(reg.size(), -1);
+  std::vector<NativeEntry> natives;
+
+  std::vector<Instruction> code = chunk.code;
+
+  for (auto&& i : code) {
+    if (i.op() != OpCode::CallNative) continue;
+
+    int& index = native_index[i.b()];
+
+    if (index == -1) {
+      index = natives.size();
+      natives.push_back({string_index(reg[i.b()].name), reg[i.b()].arity});
+    }
+
+    i = i.with_b(index);
+  }
+
+  std::vector<ConstEntry> consts;
+
+  for (auto&& x : chunk.constants) {
+    if (x.type.kind == TypeKind::Str)
+      consts.push_back({static_cast<u32>(x.type.kind),
+                        string_index(Interner::get().view(x.v_str))});
+    else
+      consts.push_back({static_cast<u32>(x.type.kind), x.v_u32});
+  }
+
+  std::vector<u32> globals;
+
+  for (auto&& x : chunk.globals)
+    globals.push_back(string_index(Interner::get().view(x)));
+
+  std::vector<u32> offsets{0};
+
+  for (auto&& x : strings) offsets.push_back(offsets.back() + x.size());
+
+  string_view data = this->source->data;
+
+  Header h{
+      .magic = MAGIC,
+      .version = FORMAT_VERSION,
+      .source_hash = this->source->hash,
+      .source_size = static_cast<u32>(data.size()),
+      .body = chunk.body,
+      .num_regs = chunk.num_regs,
+      .code_count = static_cast<u32>(code.size()),
+      .const_count = static_cast<u32>(consts.size()),
+      .global_count = static_cast<u32>(globals.size()),
+      .native_count = static_cast<u32>(natives.size()),
+      .string_count = static_cast<u32>(strings.size()),
+      .string_bytes = offsets.back(),
+  };
+
+  Writer w;
+
+  w.write(&h, 1);
+  w.write(code.data(), code.size());
+  w.write(consts.data(), consts.size());
+  w.write(globals.data(), globals.size());
+  w.write(natives.data(), natives.size());
+  w.write(offsets.data(), offsets.size());
+
+  for (auto&& x : strings) w.write(x.data(), x.size());
+
+  File file(this->path, File::WRITE | File::CREATE | File::TRUNCATE);
+
+  if (!file.IsOpen()) return false;
+
+  return file.Write(w.buf.data(), w.buf.size()) == 0;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,62 @@
+#include <algorithm>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/CompileService.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto CompileService::add(MenuEntry* e) -> void {
+  if (!e) return;
+
+  auto ctx = static_cast<EntryContext*>(e->GetArg());
+
+  // compiled ahead of time, see add_aot_entry().
+  if (ctx->is_ready()) return;
+
+  ctx->state.store(EntryContext::State::Queued, std::memory_order_relaxed);
+
+  this->queue.push_back(ctx);
+}
+
+auto CompileService::start(unsigned num_workers) -> void {
+  num_workers = std::max(1u, std::min<unsigned>(num_workers, queue.size()));
+
+  this->workers.reserve(num_workers);
+
+  for (unsigned i = 0; i < num_workers; i++)
+    if (!this->workers.emplace_back().start<&CompileService::work>(
+            this, EntryContext::BUILD_STACK_SIZE))
+      this->workers.pop_back();
+
+  // no thread could be made: build here, before the menu runs.
+  if (this->workers.empty()) this->work();
+}
+
+auto CompileService::default_workers() -> unsigned {
+#ifdef __3DS__
+  return 1;
+#else
+  // 0 where it is not known.
+  return std::max(1u, std::thread::hardware_concurrency());
+#endif
+}
+
+auto CompileService::work() -> void {
+  size_t i;
+
+  while ((i = this->next.fetch_add(1, std::memory_order_relaxed)) <
+         this->queue.size()) {
+    auto ctx = this->queue[i];
+
+    ctx->publish(ctx->build());
+  }
+}
+
+auto CompileService::wait() -> void {
+  for (auto&& t : this->workers) t.join();
+
+  this->workers.clear();
+}
+
+}  // namespace CTRPluginFramework::lua
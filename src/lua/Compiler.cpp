@@ -0,0 +1,316 @@
+#include <cstring>
+
+#include "lua/Compiler.hpp"
+#include "lua/Logger.hpp"
+#include "lua/Native.hpp"
+#include "lua/SlotUsage.hpp"
+
+namespace CTRPluginFramework::lua {
+
+using bc::Instruction;
+
+auto Compiler::compile(ast::Program* prg) -> bc::Chunk* {
+  this->chunk = new bc::Chunk();
+  this->reg_top = 0;
+  this->failed = false;
+
+  this->chunk->globals = this->source->globals;
+
+  auto prologue = this->find_prologue(prg);
+
+  for (size_t i = 0; i < prg->codes.size(); i++)
+    if (prologue[i]) this->compile_stmt(prg->codes[i]);
+
+  this->emit(Instruction::abc(OpCode::Halt, 0));
+
+  this->chunk->body = this->chunk->code.size();
+
+  for (size_t i = 0; i < prg->codes.size(); i++)
+    if (!prologue[i]) this->compile_stmt(prg->codes[i]);
+
+  this->emit(Instruction::abc(OpCode::Halt, 0));
+
+  if (this->failed) {
+    delete this->chunk;
+    this->chunk = nullptr;
+  }
+
+  return this->chunk;
+}
+
+//
+// A top-level assignment moves to the prologue when its variable is
+// stored nowhere else, is not read before it, and its value only depends
+// on constants and on variables already in the prologue.
+//
+auto Compiler::find_prologue(ast::Program* prg) -> std::vector<bool> {
+  std::vector<bool> result(prg->codes.size());
+  std::vector<bool> known(this->source->globals.size());
+
+  SlotUsage usage;
+
+  usage.collect(prg, this->source->globals.size());
+
+  for (size_t i = 0; i < prg->codes.size(); i++) {
+    if (!prg->codes[i]->is(StmtKind::Assign)) continue;
+
+    auto x = prg->codes[i]->as<ast::Assign>();
+
+    if (!x->dest->is(ExprKind::Variable)) continue;
+
+    auto slot = x->dest->as<ast::Variable>()->slot;
+
+    if (usage.is_single_store(slot) && this->is_load_time(x->source, known))
+      result[i] = known[slot] = true;
+  }
+
+  return result;
+}
+
+// memory, keys and on_enabled() are runtime inputs, so no calls.
+auto Compiler::is_load_time(ast::Expr* expr, std::vector<bool> const& known)
+    -> bool {
+  switch (expr->kind) {
+    case ExprKind::Value:
+      return true;
+
+    case ExprKind::Variable:
+      return known[expr->as<ast::Variable>()->slot];
+
+    case ExprKind::CallFunc:
+      return false;
+
+    default:
+      if (expr->is_terms()) {
+        auto x = expr->as<ast::Terms>();
+
+        if (!this->is_load_time(x->base, known)) return false;
+
+        for (auto&& [_op, term] : x->terms)
+          if (!this->is_load_time(term, known)) return false;
+
+        return true;
+      }
+      break;
+  }
+
+  return false;
+}
+
+auto Compiler::error(Token* tok, std::string const& msg) -> void {
+  this->source->add_error(Error(tok, msg));
+  this->failed = true;
+}
+
+auto Compiler::emit(Instruction i) -> size_t {
+  this->chunk->code.push_back(i);
+  return this->chunk->code.size() - 1;
+}
+
+auto Compiler::emit_jump(OpCode op, u8 a) -> size_t {
+  return this->emit(Instruction::asbx(op, a, 0));
+}
+
+auto Compiler::patch_jump(size_t at) -> void {
+  auto& i = this->chunk->code[at];
+  int offs = static_cast<int>(this->chunk->code.size() - (at + 1));
+
+  i = {Instruction::asbx(i.op(), i.a(), offs).raw |
+       (i.raw & Instruction::STMT_FLAG)};
+}
+
+auto Compiler::alloc_reg() -> u8 {
+  if (this->reg_top >= bc::MAX_REGS) {
+    this->failed = true;
+    return this->reg_top;
+  }
+
+  if (this->reg_top + 1 > this->chunk->num_regs)
+    this->chunk->num_regs = this->reg_top + 1;
+
+  return this->reg_top++;
+}
+
+auto Compiler::add_constant(Object const& obj) -> u16 {
+  auto& K = this->chunk->constants;
+
+  for (size_t i = 0; i < K.size(); i++)
+    if (K[i].type.kind == obj.type.kind && K[i].v_u32 == obj.v_u32)
+      return i;
+
+  K.push_back(obj);
+
+  return K.size() - 1;
+}
+
+auto Compiler::compile_stmt(ast::Stmt* stmt) -> void {
+  size_t begin = this->chunk->code.size();
+
+  this->compile_stmt_body(stmt);
+
+  if (begin < this->chunk->code.size())
+    this->chunk->code[begin].raw |= Instruction::STMT_FLAG;
+}
+
+auto Compiler::compile_stmt_body(ast::Stmt* stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+
+      if (!x->dest->is(ExprKind::Variable)) {
+        this->error(x->token, "cannot assign to this expression.");
+        break;
+      }
+
+      auto r = this->compile_expr(x->source);
+
+      this->emit(Instruction::abx(OpCode::SetGlobal, r,
+                                  x->dest->as<ast::Variable>()->slot));
+
+      this->free_reg();
+      break;
+    }
+
+    case StmtKind::Expr: {
+      this->compile_expr(stmt->as<ast::ExprStatement>()->expr);
+      this->free_reg();
+      break;
+    }
+
+    case StmtKind::Scope: {
+      for (auto&& x : stmt->as<ast::Scope>()->codes) this->compile_stmt(x);
+      break;
+    }
+
+    case StmtKind::If:
+      this->compile_if(stmt->as<ast::If>());
+      break;
+
+    default:
+      this->error(stmt->token, "this statement is not supported yet.");
+      break;
+  }
+}
+
+auto Compiler::compile_if(ast::If* ifs) -> void {
+  auto r = this->compile_expr(ifs->cond);
+  this->free_reg();
+
+  auto j_false = this->emit_jump(OpCode::JmpIfFalse, r);
+
+  this->compile_stmt(ifs->body);
+
+  if (!ifs->elseif && !ifs->else_body) {
+    this->patch_jump(j_false);
+    return;
+  }
+
+  auto j_end = this->emit_jump(OpCode::Jmp);
+
+  this->patch_jump(j_false);
+
+  if (ifs->elseif)
+    this->compile_if(ifs->elseif);
+  else
+    this->compile_stmt(ifs->else_body);
+
+  this->patch_jump(j_end);
+}
+
+auto Compiler::compile_expr(ast::Expr* expr) -> u8 {
+  switch (expr->kind) {
+    case ExprKind::Value: {
+      auto r = this->alloc_reg();
+      this->emit(Instruction::abx(
+          OpCode::LoadK, r, this->add_constant(*expr->as<ast::Value>()->obj)));
+      return r;
+    }
+
+    case ExprKind::Variable: {
+      auto r = this->alloc_reg();
+      this->emit(Instruction::abx(OpCode::GetGlobal, r,
+                                  expr->as<ast::Variable>()->slot));
+      return r;
+    }
+
+    case ExprKind::CallFunc:
+      return this->compile_call(expr->as<ast::CallFunc>());
+
+    default:
+      if (expr->is_terms()) return this->compile_terms(expr->as<ast::Terms>());
+      break;
+  }
+
+  this->error(expr->token, "this expression is not supported yet.");
+
+  return this->alloc_reg();
+}
+
+auto Compiler::compile_rk(ast::Expr* expr) -> u8 {
+  if (expr->is(ExprKind::Value)) {
+    auto k = this->add_constant(*expr->as<ast::Value>()->obj);
+
+    if (k < bc::RK_CONST) return bc::RK_CONST | k;
+  }
+
+  return this->compile_expr(expr);
+}
+
+auto Compiler::compile_call(ast::CallFunc* cf) -> u8 {
+  auto base = this->alloc_reg();
+
+  if (cf->native < 0 ||
+      static_cast<size_t>(cf->native) >= NativeRegistry::MAX_FUNCTIONS) {
+    this->error(cf->token, "function is not bound.");
+    return base;
+  }
+
+  for (auto&& x : cf->args) this->compile_expr(x);
+
+  this->emit(Instruction::abc(OpCode::CallNative, base, cf->native,
+                              static_cast<u8>(cf->args.size())));
+
+  this->free_reg(cf->args.size());
+
+  return base;
+}
+
+auto Compiler::compile_terms(ast::Terms* terms) -> u8 {
+  if (!ast::is_binop(terms->kind)) {
+    this->error(terms->token, "this operator is not supported yet.");
+    return this->alloc_reg();
+  }
+
+  auto binop = ast::binop_of(terms->kind);
+
+  auto dst = this->alloc_reg();
+  auto lhs = this->compile_rk(terms->base);
+
+  // kind of lhs given by TypeInfer, None if not proven.
+  auto kind = terms->base->type;
+
+  for (auto&& [_op, term] : terms->terms) {
+    auto rhs = this->compile_rk(term);
+
+    OpCode op = bc::opcode_of(binop);
+
+    // both kinds proven and equal: no checks at runtime.
+    if (kind != TypeKind::None && kind == term->type)
+      if (auto t = ops::typed_index(binop, kind); t != ops::NUM_TYPED)
+        op = static_cast<OpCode>(static_cast<size_t>(OpCode::Typed) + t);
+
+    this->emit(Instruction::abc(op, dst, lhs, rhs));
+
+    if (kind != TypeKind::None && term->type != TypeKind::None)
+      kind = ops::result_kind(binop, kind, term->type);
+    else
+      kind = TypeKind::None;
+
+    this->reg_top = dst + 1;
+    lhs = dst;
+  }
+
+  return dst;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,90 @@
+#include <cstring>
+
+#include "lua/Interner.hpp"
+
+namespace CTRPluginFramework::lua {
+
+Interner::Interner() : table(INITIAL_CAPACITY, Slot{0, EMPTY}) {}
+
+auto Interner::get() -> Interner& {
+  static Interner inst;
+  return inst;
+}
+
+// FNV-1a
+auto Interner::hash(string_view s) -> u32 {
+  u32 h = 2166136261u;
+
+  for (char c : s) {
+    h ^= static_cast<u8>(c);
+    h *= 16777619u;
+  }
+
+  return h;
+}
+
+//
+// index of the slot holding `s`, or of the empty slot where it would go.
+//
+auto Interner::probe(string_view s, u32 hash) const -> size_t {
+  size_t mask = this->table.size() - 1;
+
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    auto& slot = this->table[i];
+
+    if (slot.id == EMPTY ||
+        (slot.hash == hash && this->strings[slot.id] == s))
+      return i;
+  }
+}
+
+auto Interner::find(string_view s) const -> StringID {
+  std::lock_guard lock(this->mutex);
+
+  return this->table[this->probe(s, hash(s))].id;
+}
+
+auto Interner::intern(string_view s) -> StringID {
+  u32 h = hash(s);
+
+  std::lock_guard lock(this->mutex);
+
+  auto i = this->probe(s, h);
+
+  if (this->table[i].id != EMPTY) return this->table[i].id;
+
+  auto p = static_cast<char*>(this->bytes.alloc(s.length() + 1, 1));
+
+  std::memcpy(p, s.data(), s.length());
+  p[s.length()] = 0;
+
+  StringID id = this->strings.size();
+
+  this->strings.emplace_back(p, s.length());
+  this->table[i] = {h, id};
+
+  // keep load factor under 1/2
+  if (this->strings.size() * 2 > this->table.size()) this->grow();
+
+  return id;
+}
+
+auto Interner::grow() -> void {
+  std::vector<Slot> old(this->table.size() * 2, Slot{0, EMPTY});
+
+  old.swap(this->table);
+
+  size_t mask = this->table.size() - 1;
+
+  for (auto&& slot : old) {
+    if (slot.id == EMPTY) continue;
+
+    size_t i = slot.hash & mask;
+
+    while (this->table[i].id != EMPTY) i = (i + 1) & mask;
+
+    this->table[i] = slot;
+  }
+}
+
+}  // namespace CTRPluginFramework::lua
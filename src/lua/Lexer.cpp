@@ -1,14 +1,166 @@
-#include <cctype>
 #include <cstring>
 #include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <utility>
 
 #include "lua.hpp"
-#include "lua/utf.hpp"
+#include "lua/Interner.hpp"
 
 #define todo (std::abort())
 
 namespace CTRPluginFramework::lua {
 
+namespace {
+
+constexpr auto str_len(char const* s) -> size_t {
+  size_t n = 0;
+  while (s[n]) n++;
+  return n;
+}
+
+constexpr auto str_eq(char const* a, char const* b, size_t len) -> bool {
+  for (size_t i = 0; i < len; i++)
+    if (a[i] != b[i]) return false;
+  return true;
+}
+
+// entries of a string table that are set.
+template <typename Table>
+constexpr auto count_set(Table const& table) -> size_t {
+  size_t n = 0;
+  for (auto&& [K, S] : table) n += S != nullptr;
+  return n;
+}
+
+}  // namespace
+
+constexpr std::array<u8, 256> Lexer::g_char_class = [] {
+  std::array<u8, 256> t{};
+
+  for (u8 c : {' ', '\t', '\n', '\v', '\f', '\r'}) t[c] |= CC_Space;
+
+  for (int c = '0'; c <= '9'; c++) t[c] |= CC_Digit | CC_HexDigit | CC_Ident;
+
+  t['0'] |= CC_BinDigit;
+  t['1'] |= CC_BinDigit;
+
+  for (int c = 'a'; c <= 'f'; c++) t[c] |= CC_HexDigit;
+  for (int c = 'A'; c <= 'F'; c++) t[c] |= CC_HexDigit;
+
+  for (int c = 'a'; c <= 'z'; c++) t[c] |= CC_IdentHead | CC_Ident;
+  for (int c = 'A'; c <= 'Z'; c++) t[c] |= CC_IdentHead | CC_Ident;
+
+  t['_'] |= CC_IdentHead | CC_Ident;
+
+  return t;
+}();
+
+constexpr std::array<TokKeywords, Lexer::KWD_HASH_SIZE>
+    Lexer::g_kwd_hash_table = [] {
+      // change kwd_hash() for a new keyword that fails this.
+      static_assert(
+          [] {
+            std::array<bool, KWD_HASH_SIZE> used{};
+
+            for (auto&& [K, S] : g_kwd_str_table) {
+              if (!S) continue;
+
+              auto& slot = used[kwd_hash(S, str_len(S))];
+
+              if (slot) return false;
+
+              slot = true;
+            }
+
+            return true;
+          }(),
+          "keyword hash collision");
+
+      std::array<TokKeywords, KWD_HASH_SIZE> t{};
+
+      for (auto&& [K, S] : g_kwd_str_table)
+        if (S) t[kwd_hash(S, str_len(S))] = K;
+
+      return t;
+    }();
+
+constexpr Lexer::PunctIndex Lexer::g_punct_index = [] {
+  // a bracket takes two entries, open and close.
+  static_assert(count_set(g_punct_str_table) + count_set(g_op_str_table) +
+                        2 * count_set(g_bracket_str_table) <=
+                    PunctIndex().entries.size(),
+                "PunctIndex::entries is too small");
+
+  PunctIndex x{};
+  size_t n = 0;
+
+  auto add = [&](PunctEntry e) {
+    if (!e.len) e.len = str_len(e.str);
+
+    x.entries[n++] = e;
+  };
+
+  for (auto&& [K, S] : g_punct_str_table)
+    if (S) add({.str = S, .punct = K});
+
+  for (auto&& [K, S] : g_op_str_table)
+    if (S) add({.str = S, .op = K});
+
+  for (auto&& [K, S] : g_bracket_str_table) {
+    if (!S) continue;
+
+    for (int i = 0; i < 2; i++)
+      add({.str = S + i,
+           .len = 1,
+           .punct = TokPunctuators::Bracket,
+           .bracket = K,
+           .is_open = i == 0});
+  }
+
+  // stable sort by (first char, longer first).
+  auto before = [](PunctEntry const& a, PunctEntry const& b) {
+    if (a.str[0] != b.str[0]) return static_cast<u8>(a.str[0]) <
+                                      static_cast<u8>(b.str[0]);
+    return a.len > b.len;
+  };
+
+  for (size_t i = 1; i < n; i++)
+    for (size_t j = i; j > 0 && before(x.entries[j], x.entries[j - 1]); j--)
+      std::swap(x.entries[j], x.entries[j - 1]);
+
+  for (size_t i = n; i-- > 0;) {
+    u8 c = x.entries[i].str[0];
+
+    x.begin[c] = i;
+    x.count[c]++;
+  }
+
+  return x;
+}();
+
+auto Lexer::find_keyword(char const* s, size_t len) -> TokKeywords {
+  auto k = g_kwd_hash_table[kwd_hash(s, len)];
+
+  if (k != TokKeywords::_) {
+    char const* kw = g_kwd_str_table[static_cast<size_t>(k)].second;
+
+    if (str_eq(s, kw, len) && kw[len] == 0) return k;
+  }
+
+  return TokKeywords::_;
+}
+
+auto Lexer::find_punct(char const* s) -> PunctEntry const* {
+  u8 c = s[0];
+  auto e = g_punct_index.entries.data() + g_punct_index.begin[c];
+
+  for (auto end = e + g_punct_index.count[c]; e != end; e++)
+    if (str_eq(s, e->str, e->len)) return e;
+
+  return nullptr;
+}
+
 string_view Lexer::get_view_of(TokOperators k) {
   return g_op_str_table[static_cast<size_t>(k)].second;
 }
@@ -27,111 +179,51 @@ string_view Lexer::get_view_of(TokKeywords k) {
   return g_kwd_str_table[static_cast<size_t>(k)].second;
 }
 
-auto Lexer::lex() -> Token* {
-  Token head;
-  Token* cur = &head;
+auto Lexer::lex() -> bool {
+  Token* cur = nullptr;
+
+  auto& tokens = this->source->tokens;
+
+  tokens.clear();
+  tokens.reserve(this->source->data.length() / 4 + 1);
 
   this->pass_space();
   this->pass_comments();
 
   while (!this->is_end()) {
     char c = this->peek();
-    char* ptr = this->cur();
+    char const* ptr = this->cur();
     size_t begin = this->position;
 
     size_t line_ = this->line;
     size_t column_ = this->column;
 
-    // hex
-    if (this->consume_str("0x") || this->consume_str("0X")) {
-      cur = new Token(TokenKind::Literal, cur, this->source);
-
-      while (!this->is_end() && std::isxdigit(this->peek()))
-        this->next();
-
-      cur->literal = TokenLiterals::U32;
-
-      cur->v_u32 =
-          std::stoi(std::string(ptr, (this->position - begin)), nullptr, 16);
-    }
-
-    // bin
-    else if (this->consume_str("0b") || this->consume_str("0B")) {
-      cur = new Token(TokenKind::Literal, cur, this->source);
-
-      while (!this->is_end() && std::isxdigit(this->peek()))
-        this->next();
-
-      cur->literal = TokenLiterals::U32;
-
-      cur->v_u32 =
-          std::stoi(std::string(ptr, (this->position - begin)), nullptr, 2);
-    }
-
-    ///
-    /// digits
-    else if (std::isdigit(c)) {
-      cur = new Token(TokenKind::Literal, cur, this->source);
-
-      while (!this->is_end() && std::isdigit(this->peek()))
-        this->next();
-
-      ///
-      /// Double
-      if (this->consume('.')) {
-        while (!this->is_end() && std::isdigit(this->peek()))
-          this->next();
-
-        this->consume('f') || this->consume('F');
-
-        cur->literal = TokenLiterals::Float;
-        cur->v_float = (float)std::atof(ptr);
-      }
-
-      //
-      // Check suffixes
-      //
-      else if (this->consume('U')) {
-        cur->literal = TokenLiterals::U32;
-        cur->v_u32 = std::stoul(ptr);
-      }
-      else if (this->consume_str("UL")) {
-        cur->literal = TokenLiterals::U64;
-        cur->v_u64 = std::stoull(ptr);
-      }
-      else if (this->consume_str("LL")) {
-        cur->literal = TokenLiterals::I64;
-        cur->v_i64 = std::stoll(ptr);
-      }
-      else {
-        cur->literal = TokenLiterals::I32;
-        cur->v_i32 = std::stoi(ptr);
-        this->consume('l');
-      }
+    //
+    // number
+    if (is(c, CC_Digit)) {
+      cur = this->push(TokenKind::Literal);
+      this->lex_number(cur);
     }
 
     //
     // identifier
-    else if (std::isalpha(c) || c == '_') {
-      cur = new Token(TokenKind::Identifier, cur, this->source);
+    else if (is(c, CC_IdentHead)) {
+      cur = this->push(TokenKind::Identifier);
 
-      while (!this->is_end() && (std::isalnum((c = this->peek())) || c == '_'))
-        this->next();
+      this->skip(CC_Ident);
 
-      for (auto&& [_k, _s] : g_kwd_str_table)
-        if (_s && (this->position - begin) == std::strlen(_s) &&
-            std::strncmp(ptr, _s, (this->position - begin)) == 0) {
-          cur->kind = TokenKind::Keyword;
-          cur->kwd = _k;
-          break;
-        }
+      if (auto k = this->find_keyword(ptr, this->position - begin);
+          k != TokKeywords::_) {
+        cur->kind = TokenKind::Keyword;
+        cur->kwd = k;
+      }
     }
 
     //
     // string literal
     else if (this->consume('"') || this->consume('\'')) {
       if (this->consume(c)) {
-        cur = new Token(TokenKind::Literal, cur, this->source);
+        cur = this->push(TokenKind::Literal);
         cur->literal = TokenLiterals::StringEmpty;
       } else {
         while (!this->consume(c)) {
@@ -143,57 +235,39 @@ auto Lexer::lex() -> Token* {
           this->next();
         }
 
-        cur = new Token(TokenKind::Literal, cur, this->source);
+        cur = this->push(TokenKind::Literal);
         cur->literal = TokenLiterals::String;
 
         assert((this->cur() - ptr) >= 2);
 
         this->str_literal_create_task.emplace_back(
-            cur, string_view(ptr + 1, this->position - begin - 2));
+            tokens.size() - 1, string_view(ptr + 1, this->position - begin - 2));
       }
     }
 
     //
     // other
     else {
-      cur = new Token(TokenKind::Punctuator, cur, this->source);
+      cur = this->push(TokenKind::Punctuator);
 
-      for (auto&& [K, S] : g_punct_str_table) {
-        if (S && this->consume_str(S)) {
-          cur->punct = K;
-          goto _end_of_find;
-        }
-      }
+      if (auto e = this->find_punct(ptr)) {
+        cur->op = e->op;
+        cur->punct = e->punct;
+        cur->bracket = e->bracket;
+        cur->is_brac_open = e->is_open;
 
-      for (auto&& [K, S] : g_op_str_table) {
-        if (S && this->consume_str(S)) {
-          cur->op = K;
-          goto _end_of_find;
-        }
+        this->position += e->len;
+        this->column += e->len;
       }
-
-      for (auto&& [K, S] : g_bracket_str_table) {
-        if (S && this->consume(S[0])) {
-          cur->punct = TokPunctuators::Bracket;
-          cur->bracket = K;
-          cur->is_brac_open = true;
-          goto _end_of_find;
-        } else if (S && this->consume(S[1])) {
-          cur->punct = TokPunctuators::Bracket;
-          cur->bracket = K;
-          cur->is_brac_open = false;
-          goto _end_of_find;
-        }
+      else {
+        this->source->add_error(Error(line_,column_,"invalid token"));
+        this->next();
       }
-
-      this->source->add_error(Error(line_,column_,"invalid token"));
-
-    _end_of_find:;
     }
 
     cur->position = begin;
     cur->length = this->position - cur->position;
-    cur->str = this->get_str_id(ptr, cur->length);
+    cur->str = Interner::get().intern(string_view(ptr, cur->length));
     cur->line = line_;
     cur->column = column_;
 
@@ -201,53 +275,131 @@ auto Lexer::lex() -> Token* {
     this->pass_comments();
   }
 
-  cur = new Token(TokenKind::Eof, cur, this->source);
+  this->push(TokenKind::Eof);
 
   this->create_str_literals();
 
-  Token* root = head.next;
+  return this->source->errors.empty();
+}
 
-  head.next = nullptr;
+//
+// Numeric literal at the current position, parsed in place. Values that
+// do not fit the literal's type are reported, not thrown.
+//
+auto Lexer::lex_number(Token* tok) -> void {
+  char const* ptr = this->cur();
 
-  return root;
-}
+  size_t line_ = this->line;
+  size_t column_ = this->column;
 
-void Lexer::create_str_literals() {
-  this->str_literal_pool.reserve(this->str_literal_create_task.size());
+  auto error = [&](char const* msg) {
+    this->source->add_error(Error(line_, column_, msg));
+  };
+
+  int base = 10;
+
+  if (ptr[0] == '0' && (ptr[1] == 'x' || ptr[1] == 'X'))
+    base = 16;
+  else if (ptr[0] == '0' && (ptr[1] == 'b' || ptr[1] == 'B'))
+    base = 2;
+
+  u64 value = 0;
 
-  for (auto& [tok, view] : this->str_literal_create_task) {
-    std::u16string& s =
-        this->str_literal_pool.emplace_back(utf::utf8_to_utf16(view));
+  if (base == 10) this->skip(CC_Digit);
 
-    tok->v_str = &s;
+  // hex or bin: U32, or U64 with `UL
+  if (base != 10) {
+    this->position += 2;
+    this->column += 2;
+
+    char const* first = this->cur();
+
+    this->skip(base == 16 ? CC_HexDigit : CC_BinDigit);
+
+    auto [_p, ec] = std::from_chars(first, this->cur(), value, base);
+
+    if (first == this->cur())
+      error("expected digits after the prefix.");
+    else if (ec == std::errc::result_out_of_range)
+      error("integer literal is too large.");
+
+    if (this->consume_str("UL")) {
+      tok->literal = TokenLiterals::U64;
+      tok->v_u64 = value;
+    }
+    else {
+      this->consume('U');
+
+      if (value > UINT32_MAX) error("integer literal is too large for u32.");
+
+      tok->literal = TokenLiterals::U32;
+      tok->v_u32 = static_cast<u32>(value);
+    }
   }
 
-  this->str_literal_create_task.clear();
-}
+  // Float, with optional `f
+  else if (this->consume('.')) {
+    this->skip(CC_Digit);
 
-auto Lexer::get_strview(StringID id) -> string_view {
-  return this->strpool[id];
-}
+    auto [_p, ec] = std::from_chars(ptr, this->cur(), tok->v_float);
+
+    if (ec == std::errc::result_out_of_range)
+      error("float literal is out of range.");
+
+    tok->literal = TokenLiterals::Float;
+
+    this->consume('f') || this->consume('F');
+  }
+
+  // decimal integer, suffix decides the type
+  else {
+    auto [_p, ec] = std::from_chars(ptr, this->cur(), value);
+
+    if (ec == std::errc::result_out_of_range) {
+      error("integer literal is too large.");
+      value = 0;
+    }
+
+    if (this->consume_str("UL")) {
+      tok->literal = TokenLiterals::U64;
+      tok->v_u64 = value;
+    }
+    else if (this->consume_str("LL")) {
+      if (value > INT64_MAX) error("integer literal is too large for i64.");
+
+      tok->literal = TokenLiterals::I64;
+      tok->v_i64 = static_cast<i64>(value);
+    }
+    else if (this->consume('U')) {
+      if (value > UINT32_MAX) error("integer literal is too large for u32.");
 
-auto Lexer::get_str_id(string_view s) -> StringID {
-  for (StringID i = 0; i < this->strpool.size(); i++)
-    if (this->strpool[i].length() == s.length() && this->strpool[i] == s)
-      return i;
+      tok->literal = TokenLiterals::U32;
+      tok->v_u32 = static_cast<u32>(value);
+    }
+    else {
+      if (value > INT32_MAX) error("integer literal is too large for i32.");
 
-  this->strpool.push_back(string(s));
+      tok->literal = TokenLiterals::I32;
+      tok->v_i32 = static_cast<i32>(value);
+
+      this->consume('l');
+    }
+  }
 
-  return this->strpool.size() - 1;
+  // such as `0b102` or `12abc`
+  if (is(this->peek(), CC_Ident)) {
+    error("invalid digit or suffix in numeric literal.");
+    this->skip(CC_Ident);
+  }
 }
 
-auto Lexer::get_str_id(char const* ptr, size_t len) -> StringID {
-  for (StringID i = 0; i < this->strpool.size(); i++)
-    if (this->strpool[i].length() == len &&
-        std::strncmp(this->strpool[i].data(), ptr, len) == 0)
-      return i;
+void Lexer::create_str_literals() {
+  auto& interner = Interner::get();
 
-  this->strpool.push_back(string(ptr, len));
+  for (auto& [tok, view] : this->str_literal_create_task)
+    this->source->tokens[tok].v_str = interner.intern(view);
 
-  return this->strpool.size() - 1;
+  this->str_literal_create_task.clear();
 }
 
 void Lexer::pass_comments() {
@@ -0,0 +1,57 @@
+#include "lua/Native.hpp"
+#include "lua/ObjectOps.hpp"
+
+namespace CTRPluginFramework::lua {
+
+NativeRegistry::NativeRegistry() { register_builtins(*this); }
+
+auto NativeRegistry::get() -> NativeRegistry& {
+  static NativeRegistry inst;
+  return inst;
+}
+
+auto NativeRegistry::add(char const* name, NativeFunc fn,
+                         std::initializer_list<TypeKind> params,
+                         TypeKind result) -> u16 {
+  NativeFunction& F = this->functions.emplace_back();
+
+  F.name = name;
+  F.fn = fn;
+  F.arity = params.size();
+  F.result = result;
+
+  int i = 0;
+  for (auto&& t : params) F.params[i++] = t;
+
+  return this->functions.size() - 1;
+}
+
+auto NativeRegistry::add_variadic(char const* name, NativeFunc fn,
+                                  TypeKind result) -> u16 {
+  NativeFunction& F = this->functions.emplace_back();
+
+  F.name = name;
+  F.fn = fn;
+  F.arity = -1;
+  F.result = result;
+
+  return this->functions.size() - 1;
+}
+
+auto NativeRegistry::find(string_view name) const -> int {
+  for (size_t i = 0; i < this->functions.size(); i++)
+    if (name == this->functions[i].name) return i;
+
+  return NOT_FOUND;
+}
+
+auto NativeRegistry::invoke(NativeFunction const& F, NativeCall& call)
+    -> Object {
+  for (int i = 0; i < F.arity; i++)
+    if (call.args[i].type.kind != F.params[i])
+      convert_object(call.args[i], F.params[i]);
+
+  return F.fn(call);
+}
+
+}  // namespace CTRPluginFramework::lua
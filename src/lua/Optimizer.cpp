@@ -0,0 +1,263 @@
+#include "lua/Optimizer.hpp"
+#include "lua/ObjectOps.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto Optimizer::optimize(ast::Program* prg) -> size_t {
+  size_t before = 0;
+  size_t after = 0;
+
+  for (auto&& x : prg->codes) before += count_stmt(x);
+
+  do {
+    this->changed = false;
+    this->propagate(prg);
+  } while (this->changed);
+
+  for (auto&& x : prg->codes) after += count_stmt(x);
+
+  return before - after;
+}
+
+//
+// Find globals that can be replaced by a constant, replace their reads,
+// then drop their assignments.
+//
+auto Optimizer::propagate(ast::Program* prg) -> void {
+  auto& codes = prg->codes;
+
+  this->usage.collect(prg, this->source->globals.size());
+
+  this->values.assign(this->source->globals.size(), nullptr);
+
+  for (size_t i = 0; i < this->values.size(); i++) {
+    if (!this->usage.is_single_store(i)) continue;
+
+    auto x = this->usage[i].top_assign;
+
+    // a value of another kind than declared is left to TypeInfer.
+    if (x->source->is(ExprKind::Value) &&
+        (x->declared == TypeKind::None ||
+         x->declared == x->source->as<ast::Value>()->obj->type.kind))
+      this->values[i] = x->source->as<ast::Value>();
+  }
+
+  this->fold_block(codes);
+
+  for (auto it = codes.begin(); it != codes.end();) {
+    if ((*it)->is(StmtKind::Assign)) {
+      auto x = (*it)->as<ast::Assign>();
+
+      if (x->dest->is(ExprKind::Variable) &&
+          this->values[x->dest->as<ast::Variable>()->slot]) {
+        it = codes.erase(it);
+        this->changed = true;
+        continue;
+      }
+    }
+
+    it++;
+  }
+}
+
+auto Optimizer::fold_block(ArenaVec<ast::Stmt*>& codes) -> void {
+  for (auto it = codes.begin(); it != codes.end();) {
+    this->fold_stmt(*it);
+
+    // statement without any effect
+    if (*it && (*it)->is(StmtKind::Expr) &&
+        (*it)->as<ast::ExprStatement>()->expr->is(ExprKind::Value)) {
+      *it = nullptr;
+    }
+
+    if (*it)
+      it++;
+    else {
+      it = codes.erase(it);
+      this->changed = true;
+    }
+  }
+}
+
+//
+// `stmt` is replaced with its live branch, or nullptr if nothing remains.
+//
+auto Optimizer::fold_stmt(ast::Stmt*& stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+
+      this->fold_expr(x->source);
+
+      // `x: f32 = 1` stores 1.0
+      if (ops::is_num(x->declared) && x->source->is(ExprKind::Value)) {
+        auto& obj = *x->source->as<ast::Value>()->obj;
+
+        if (ops::is_num(obj.type.kind) && obj.type.kind != x->declared) {
+          convert_object(obj, x->declared);
+          this->changed = true;
+        }
+      }
+      break;
+    }
+
+    case StmtKind::Expr:
+      this->fold_expr(stmt->as<ast::ExprStatement>()->expr);
+      break;
+
+    case StmtKind::Scope:
+      this->fold_block(stmt->as<ast::Scope>()->codes);
+      break;
+
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+
+      this->fold_expr(x->cond);
+      this->fold_block(x->body->codes);
+
+      if (x->else_body) this->fold_block(x->else_body->codes);
+
+      if (x->elseif) {
+        ast::Stmt* e = x->elseif;
+
+        this->fold_stmt(e);
+
+        // an `elseif` with constant condition became a plain block.
+        x->elseif = nullptr;
+
+        if (e && e->is(StmtKind::If))
+          x->elseif = e->as<ast::If>();
+        else if (e)
+          x->else_body = e->as<ast::Scope>();
+      }
+
+      if (!x->cond->is(ExprKind::Value)) break;
+
+      if (x->cond->as<ast::Value>()->obj->v_bool) {
+        stmt = x->body;
+        x->body = nullptr;
+      }
+      else if (x->elseif) {
+        stmt = x->elseif;
+        x->elseif = nullptr;
+      }
+      else if (x->else_body) {
+        stmt = x->else_body;
+        x->else_body = nullptr;
+      }
+      else
+        stmt = nullptr;
+
+      this->changed = true;
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+auto Optimizer::fold_expr(ast::Expr*& expr) -> void {
+  switch (expr->kind) {
+    case ExprKind::Value:
+      break;
+
+    case ExprKind::Variable: {
+      auto x = expr->as<ast::Variable>();
+      auto& A = this->source->arena;
+
+      if (auto val = this->values[x->slot]) {
+        expr = A.make<ast::Value>(x->token, A.make<Object>(*val->obj));
+        this->changed = true;
+      }
+      break;
+    }
+
+    case ExprKind::CallFunc:
+      for (auto&& x : expr->as<ast::CallFunc>()->args) this->fold_expr(x);
+      break;
+
+    default:
+      if (expr->is_terms()) expr = this->fold_terms(expr->as<ast::Terms>());
+      break;
+  }
+}
+
+//
+// Fold the leading constant operands. Evaluation is left to right, so
+// `1 + 2 + x` becomes `3 + x` but `x + 1 + 2` is left as it is.
+//
+auto Optimizer::fold_terms(ast::Terms* terms) -> ast::Expr* {
+  this->fold_expr(terms->base);
+
+  for (auto&& [_op, term] : terms->terms) this->fold_expr(term);
+
+  if (!terms->base->is(ExprKind::Value) || !ast::is_binop(terms->kind))
+    return terms;
+
+  auto op = ast::binop_of(terms->kind);
+  auto& lhs = *terms->base->as<ast::Value>()->obj;
+
+  auto it = terms->terms.begin();
+
+  for (; it != terms->terms.end() && it->second->is(ExprKind::Value); it++) {
+    lhs = binary_op(op, lhs, *it->second->as<ast::Value>()->obj);
+    this->changed = true;
+  }
+
+  terms->terms.erase(terms->terms.begin(), it);
+
+  if (!terms->terms.empty()) return terms;
+
+  return terms->base;
+}
+
+auto Optimizer::count_stmt(ast::Stmt* stmt) -> size_t {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+      return 1 + count_expr(x->dest) + count_expr(x->source);
+    }
+
+    case StmtKind::Expr:
+      return 1 + count_expr(stmt->as<ast::ExprStatement>()->expr);
+
+    case StmtKind::Scope: {
+      size_t n = 1;
+      for (auto&& x : stmt->as<ast::Scope>()->codes) n += count_stmt(x);
+      return n;
+    }
+
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+      size_t n = 1 + count_expr(x->cond) + count_stmt(x->body);
+
+      if (x->elseif) n += count_stmt(x->elseif);
+      if (x->else_body) n += count_stmt(x->else_body);
+
+      return n;
+    }
+
+    default:
+      return 1;
+  }
+}
+
+auto Optimizer::count_expr(ast::Expr* expr) -> size_t {
+  if (expr->is(ExprKind::CallFunc)) {
+    size_t n = 1;
+    for (auto&& x : expr->as<ast::CallFunc>()->args) n += count_expr(x);
+    return n;
+  }
+
+  if (expr->is_terms()) {
+    auto x = expr->as<ast::Terms>();
+    size_t n = 1 + count_expr(x->base);
+    for (auto&& [_op, term] : x->terms) n += count_expr(term);
+    return n;
+  }
+
+  return 1;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,97 @@
+#include "CTRPluginFramework.hpp"
+
+#include "lua/PageCache.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto PageCache::get() -> PageCache& {
+  static PageCache inst;
+  return inst;
+}
+
+auto PageCache::check_locked(u32 addr, u32 perm) -> bool {
+  u32 page = addr / PAGE_SIZE;
+  u8 bit = 1 << (perm & 7);
+
+  Page& p = this->pages[slot_of(page)];
+
+  if (p.epoch != this->epoch || p.page != page)
+    p = {.page = page, .epoch = this->epoch};
+  else if (p.known & bit) {
+    this->stats.hits++;
+    return p.valid & bit;
+  }
+
+  this->stats.queries++;
+
+  bool valid = Process::CheckAddress(addr, perm);
+
+  p.known |= bit;
+
+  if (valid) p.valid |= bit;
+
+  return valid;
+}
+
+auto PageCache::fault(u32 addr, u32 size) -> void {
+  std::lock_guard lock(this->mutex);
+
+  this->stats.faults++;
+
+  for (u32 page : {addr / PAGE_SIZE, (addr + size - 1) / PAGE_SIZE}) {
+    Page& p = this->pages[slot_of(page)];
+
+    if (p.page == page) p.epoch = 0;
+  }
+}
+
+auto PageCache::read(u32 addr, void* out, u32 size) -> bool {
+  u32 end = addr + size - 1;
+
+  {
+    std::lock_guard lock(this->mutex);
+
+    if (!this->check_locked(addr, MEMPERM_READ) ||
+        ((addr ^ end) >= PAGE_SIZE && !this->check_locked(end, MEMPERM_READ)))
+      return false;
+  }
+
+  if (Process::CopyMemory(out, reinterpret_cast<void const*>(addr), size))
+    return true;
+
+  this->fault(addr, size);
+
+  return false;
+}
+
+auto PageCache::write(u32 addr, void const* in, u32 size) -> bool {
+  u32 end = addr + size - 1;
+
+  {
+    std::lock_guard lock(this->mutex);
+
+    if (!this->check_locked(addr, MEMPERM_WRITE) ||
+        ((addr ^ end) >= PAGE_SIZE && !this->check_locked(end, MEMPERM_WRITE)))
+      return false;
+  }
+
+  if (Process::CopyMemory(reinterpret_cast<void*>(addr), in, size))
+    return true;
+
+  this->fault(addr, size);
+
+  return false;
+}
+
+auto PageCache::new_frame() -> void {
+  std::lock_guard lock(this->mutex);
+
+  if (++this->frames < this->interval) return;
+
+  this->frames = 0;
+
+  // skip 0 on wrap around.
+  if (++this->epoch == 0) this->epoch = 1;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,80 @@
+#include <cstring>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/PageCache.hpp"
+#include "lua/ReadCache.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto ReadCache::get() -> ReadCache& {
+  static ReadCache inst;
+  return inst;
+}
+
+auto ReadCache::read(u32 addr, void* out, u32 size) -> bool {
+  u32 base = addr & ~(BLOCK - 1);
+  u32 offs = addr - base;
+
+  std::lock_guard lock(this->mutex);
+
+  // straddles two blocks, read it directly.
+  if (offs + size > BLOCK) {
+    this->stats.uncached++;
+
+    return PageCache::get().read(addr, out, size);
+  }
+
+  Block& b = this->blocks[slot_of(base)];
+
+  if (b.frame == this->frame && b.base == base)
+    this->stats.hits++;
+  else {
+    if (!PageCache::get().read(base, b.data, BLOCK)) {
+      this->stats.uncached++;
+      b.frame = 0;
+      return false;
+    }
+
+    this->stats.misses++;
+    b.base = base;
+    b.frame = this->frame;
+  }
+
+  std::memcpy(out, b.data + offs, size);
+
+  return true;
+}
+
+auto ReadCache::invalidate(u32 addr, u32 size) -> void {
+  if (!size) return;
+
+  std::lock_guard lock(this->mutex);
+
+  u32 last = (addr + size - 1) & ~(BLOCK - 1);
+
+  for (u32 base = addr & ~(BLOCK - 1);; base += BLOCK) {
+    Block& b = this->blocks[slot_of(base)];
+
+    if (b.base == base) b.frame = 0;
+
+    if (base == last) break;
+  }
+}
+
+auto ReadCache::new_frame() -> void {
+  std::lock_guard lock(this->mutex);
+
+  // skip 0 on wrap around.
+  if (++this->frame == 0) this->frame = 1;
+}
+
+auto ReadCache::hit_rate() const -> float {
+  std::lock_guard lock(this->mutex);
+
+  u32 total = this->stats.hits + this->stats.misses + this->stats.uncached;
+
+  return total ? static_cast<float>(this->stats.hits) / total : 0.0f;
+}
+
+}  // namespace CTRPluginFramework::lua
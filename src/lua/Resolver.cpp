@@ -0,0 +1,136 @@
+#include "lua/Resolver.hpp"
+#include "lua/Native.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto Resolver::resolve(ast::Program* prg) -> bool {
+  this->failed = false;
+
+  this->slot_of.clear();
+
+  // keep slots given by an earlier pass.
+  for (size_t i = 0; i < this->source->globals.size(); i++) {
+    auto name = this->source->globals[i];
+
+    if (name >= this->slot_of.size()) this->slot_of.resize(name + 1, NO_SLOT);
+
+    this->slot_of[name] = i;
+  }
+
+  for (auto&& x : prg->codes) this->resolve_stmt(x);
+
+  return !this->failed;
+}
+
+auto Resolver::get_slot(StringID name) -> int {
+  if (name >= this->slot_of.size()) this->slot_of.resize(name + 1, NO_SLOT);
+
+  if (auto& slot = this->slot_of[name]; slot != NO_SLOT) return slot;
+
+  this->source->globals.push_back(name);
+
+  return this->slot_of[name] = this->source->globals.size() - 1;
+}
+
+auto Resolver::resolve_stmt(ast::Stmt* stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+      this->resolve_expr(x->dest);
+      this->resolve_expr(x->source);
+      break;
+    }
+
+    case StmtKind::Expr:
+      this->resolve_expr(stmt->as<ast::ExprStatement>()->expr);
+      break;
+
+    case StmtKind::Scope:
+      for (auto&& x : stmt->as<ast::Scope>()->codes) this->resolve_stmt(x);
+      break;
+
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+
+      this->resolve_expr(x->cond);
+      this->resolve_stmt(x->body);
+
+      if (x->elseif) this->resolve_stmt(x->elseif);
+      if (x->else_body) this->resolve_stmt(x->else_body);
+
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+auto Resolver::resolve_expr(ast::Expr* expr) -> void {
+  switch (expr->kind) {
+    case ExprKind::Value:
+      break;
+
+    case ExprKind::Variable: {
+      auto x = expr->as<ast::Variable>();
+      auto slot = this->get_slot(x->name);
+
+      if (slot > UINT16_MAX) {
+        this->source->add_error(Error(x->token, "too many variables."));
+        this->failed = true;
+        break;
+      }
+
+      x->slot = slot;
+      break;
+    }
+
+    case ExprKind::CallFunc: {
+      auto x = expr->as<ast::CallFunc>();
+
+      this->bind_native(x);
+
+      for (auto&& arg : x->args) this->resolve_expr(arg);
+
+      break;
+    }
+
+    default:
+      if (expr->is_terms()) {
+        auto x = expr->as<ast::Terms>();
+
+        this->resolve_expr(x->base);
+
+        for (auto&& [_op, term] : x->terms) this->resolve_expr(term);
+      }
+      break;
+  }
+}
+
+auto Resolver::bind_native(ast::CallFunc* cf) -> void {
+  auto& natives = NativeRegistry::get();
+
+  if (!cf->functor->is(ExprKind::Variable)) {
+    this->source->add_error(Error(cf->token, "cannot call this expression."));
+    this->failed = true;
+    return;
+  }
+
+  auto name = cf->functor->token->get_strview();
+
+  if ((cf->native = natives.find(name)) == NativeRegistry::NOT_FOUND) {
+    this->source->add_error(Error(cf->functor->token,
+                                  "unknown function '" + string(name) + "'"));
+    this->failed = true;
+    return;
+  }
+
+  if (auto& F = natives[cf->native];
+      F.arity >= 0 && static_cast<size_t>(F.arity) != cf->args.size()) {
+    this->source->add_error(Error(
+        cf->token, Utils::Format("'%s' takes %d argument(s).", F.name, F.arity)));
+    this->failed = true;
+  }
+}
+
+}  // namespace CTRPluginFramework::lua
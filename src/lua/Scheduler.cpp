@@ -0,0 +1,86 @@
+#include <algorithm>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/Scheduler.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto Scheduler::add(MenuEntry* e, u8 priority, u32 budget) -> void {
+  if (!e) return;
+
+  this->tasks.push_back({
+      .ctx = static_cast<EntryContext*>(e->GetArg()),
+      .priority = priority,
+      .budget = budget,
+  });
+
+  this->order.reserve(this->tasks.size());
+}
+
+auto Scheduler::run_frame() -> void {
+  Clock frame;
+
+  bool out_of_time = false;
+
+  this->order.clear();
+
+  for (auto&& t : this->tasks) this->order.push_back(&t);
+
+  // stable: equal priorities keep the order they were added in.
+  std::stable_sort(this->order.begin(), this->order.end(),
+                   [](Task const* a, Task const* b) {
+                     return a->priority + a->age > b->priority + b->age;
+                   });
+
+  for (auto p : this->order) {
+    auto& t = *p;
+
+    if (!t.ctx->entry->IsActivated() || !t.ctx->is_ready()) continue;
+
+    // its worker may be running it right now.
+    if (t.ctx->async) continue;
+
+    if (out_of_time || frame.HasTimePassed(this->frame_budget)) {
+      out_of_time = true;
+      t.deferred++;
+      t.age++;
+      continue;
+    }
+
+    t.age = 0;
+
+    Clock clock;
+
+    u32 left = t.budget;
+    auto status = VM::Status::Preempted;
+
+    while (left) {
+      u32 steps = std::min(SLICE, left);
+
+      left -= steps;
+      status = t.ctx->step(steps);
+      left += steps;
+
+      if (status != VM::Status::Preempted) break;
+
+      if (frame.HasTimePassed(this->frame_budget)) {
+        out_of_time = true;
+        break;
+      }
+    }
+
+    if (auto time = clock.GetElapsedTime(); t.worst < time) t.worst = time;
+
+    if (status != VM::Status::Preempted)
+      t.runs++;
+    else if (out_of_time)
+      t.deferred++;
+    else
+      t.overruns++;
+  }
+
+  if (out_of_time) this->late_frames++;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,92 @@
+#include "lua/SlotUsage.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto SlotUsage::collect(ast::Program* prg, size_t num_slots) -> void {
+  auto& codes = prg->codes;
+
+  this->slots.assign(num_slots, {});
+
+  for (size_t i = 0; i < codes.size(); i++) {
+    this->cur_index = i;
+    this->collect_stmt(codes[i]);
+
+    if (codes[i]->is(StmtKind::Assign)) {
+      auto x = codes[i]->as<ast::Assign>();
+
+      if (x->dest->is(ExprKind::Variable)) {
+        auto& S = this->slots[x->dest->as<ast::Variable>()->slot];
+        S.top_assign = x;
+        S.top_index = i;
+      }
+    }
+  }
+}
+
+auto SlotUsage::collect_stmt(ast::Stmt* stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+
+      if (x->dest->is(ExprKind::Variable))
+        this->slots[x->dest->as<ast::Variable>()->slot].assign_count++;
+      else
+        this->collect_expr(x->dest);
+
+      this->collect_expr(x->source);
+      break;
+    }
+
+    case StmtKind::Expr:
+      this->collect_expr(stmt->as<ast::ExprStatement>()->expr);
+      break;
+
+    case StmtKind::Scope:
+      for (auto&& x : stmt->as<ast::Scope>()->codes) this->collect_stmt(x);
+      break;
+
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+
+      this->collect_expr(x->cond);
+      this->collect_stmt(x->body);
+
+      if (x->elseif) this->collect_stmt(x->elseif);
+      if (x->else_body) this->collect_stmt(x->else_body);
+
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+auto SlotUsage::collect_expr(ast::Expr* expr) -> void {
+  switch (expr->kind) {
+    case ExprKind::Value:
+      break;
+
+    case ExprKind::Variable: {
+      auto& S = this->slots[expr->as<ast::Variable>()->slot];
+      S.first_read = std::min(S.first_read, this->cur_index);
+      break;
+    }
+
+    case ExprKind::CallFunc:
+      for (auto&& x : expr->as<ast::CallFunc>()->args) this->collect_expr(x);
+      break;
+
+    default:
+      if (expr->is_terms()) {
+        auto x = expr->as<ast::Terms>();
+
+        this->collect_expr(x->base);
+
+        for (auto&& [_op, term] : x->terms) this->collect_expr(term);
+      }
+      break;
+  }
+}
+
+}  // namespace CTRPluginFramework::lua
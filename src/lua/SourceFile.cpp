@@ -5,43 +5,75 @@
 #include "lua/SourceFile.hpp"
 #include "lua/Lexer.hpp"
 #include "lua/Parser.hpp"
+#include "lua/Compiler.hpp"
+#include "lua/Interner.hpp"
 
 namespace CTRPluginFramework::lua {
 
 SourceFile::SourceFile(std::string const& path)
   : path(path),
+    buffer(),
     data(),
     imports(),
-    file(path),
     lexer(new Lexer(this)),
     parser(new Parser(this)),
-    token(nullptr),
-    program(nullptr)
+    compiler(new Compiler(this)),
+    tokens(),
+    arena(),
+    program(nullptr),
+    chunk(nullptr)
 {
 }
 
 SourceFile::~SourceFile() {
   if (this->lexer) delete this->lexer;
   if (this->parser) delete this->parser;
-  if(this->token)delete token;
-  if(this->program) delete program;
+  if (this->compiler) delete this->compiler;
+  if (this->chunk) delete chunk;
+}
+
+auto SourceFile::reset() -> void {
+  for (auto&& e : this->errors) delete e;
+
+  this->errors.clear();
+  this->tokens.clear();
+  this->globals.clear();
+
+  this->release_program();
+
+  delete this->chunk;
+  this->chunk = nullptr;
+
+  // the old text's string literals stay in the Interner, which never
+  // frees; the same text gets the same ids on the next build.
+  delete this->lexer;
+  this->lexer = new Lexer(this);
+
+  this->buffer.reset();
+  this->data = string_view();
+  this->hash = 0;
 }
 
 bool SourceFile::read() {
 
-  if (!this->file.IsOpen()) {
+  File file(this->path, File::READ);
+
+  if (!file.IsOpen()) {
     // (MessageBox("failed to open path '" + this->path + "'"))();
     return false;
   }
 
-  auto reader = LineReader(this->file);
+  u64 size = file.GetSize();
 
-  std::string line;
+  auto buf = std::unique_ptr<char[]>(new char[size + 1]);
 
-  while (reader(line)) {
-    line.push_back('\n');
-    this->data.append(line);
-  }
+  if (size && file.Read(buf.get(), size) != 0) return false;
+
+  buf[size] = 0;
+
+  this->buffer = std::move(buf);
+  this->data = string_view(this->buffer.get(), size);
+  this->hash = Interner::hash(this->data);
 
   return true;
 }
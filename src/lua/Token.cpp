@@ -1,5 +1,6 @@
 #include "lua/Token.hpp"
 #include "lua/Lexer.hpp"
+#include "lua/Interner.hpp"
 
 namespace CTRPluginFramework::lua {
 
@@ -25,7 +26,7 @@ std::string_view Token::get_strview() {
   if (this->is(TokenKind::Eof)) return "<@Eof>";
 #endif
 
-  return this->get_lexer()->get_strview(this->str);
+  return Interner::get().view(this->str);
 }
 
 std::string_view Token::get_line_view(int offs, int count) {
@@ -35,7 +36,7 @@ std::string_view Token::get_line_view(int offs, int count) {
 }
 
 StringID Token::set_string(std::string const& str) {
-  return (this->str = this->get_lexer()->get_str_id(str));
+  return (this->str = Interner::get().intern(str));
 }
 
 }  // namespace CTRPluginFramework::lua
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "lua/TypeInfer.hpp"
+#include "lua/Native.hpp"
+#include "lua/ObjectOps.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto TypeInfer::infer(ast::Program* prg) -> bool {
+  this->failed = false;
+
+  this->slots.assign(this->source->globals.size(), {});
+
+  for (auto&& x : prg->codes) this->declare_stmt(x);
+
+  if (this->failed) return false;
+
+  // kinds only grow Unset -> Known -> Mixed, so this ends.
+  do {
+    this->changed = false;
+    this->assigned.assign(this->slots.size(), false);
+
+    for (auto&& x : prg->codes) this->infer_stmt(x);
+  } while (this->changed);
+
+  for (auto&& x : prg->codes) this->check_stmt(x);
+
+  return !this->failed;
+}
+
+auto TypeInfer::error(Token* tok, std::string const& msg) -> void {
+  this->source->add_error(Error(tok, msg));
+  this->failed = true;
+}
+
+auto TypeInfer::declare_stmt(ast::Stmt* stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+
+      if (x->declared == TypeKind::None || !x->dest->is(ExprKind::Variable))
+        break;
+
+      auto& S = this->slots[x->dest->as<ast::Variable>()->slot];
+
+      if (S.declared == TypeKind::None) {
+        S.declared = x->declared;
+        S.declared_at = x->type_tok;
+        S.type = {State::Known, x->declared};
+      }
+      else if (S.declared != x->declared) {
+        this->error(x->type_tok, std::string("already declared as ") +
+                                     type_name(S.declared) + ".");
+      }
+      break;
+    }
+
+    case StmtKind::Scope:
+      for (auto&& x : stmt->as<ast::Scope>()->codes) this->declare_stmt(x);
+      break;
+
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+
+      this->declare_stmt(x->body);
+
+      if (x->elseif) this->declare_stmt(x->elseif);
+      if (x->else_body) this->declare_stmt(x->else_body);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+auto TypeInfer::store(u16 slot, Type type) -> void {
+  auto& T = this->slots[slot].type;
+
+  if (type.state == State::Unset || T == type || T.state == State::Mixed)
+    return;
+
+  T = T.state == State::Unset ? type : Type{State::Mixed};
+
+  this->changed = true;
+}
+
+auto TypeInfer::infer_stmt(ast::Stmt* stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+      auto type = this->infer_expr(x->source);
+
+      if (!x->dest->is(ExprKind::Variable)) break;
+
+      auto slot = x->dest->as<ast::Variable>()->slot;
+
+      this->store(slot, type);
+
+      this->assigned[slot] = true;
+      break;
+    }
+
+    case StmtKind::Expr:
+      this->infer_expr(stmt->as<ast::ExprStatement>()->expr);
+      break;
+
+    case StmtKind::Scope:
+      for (auto&& x : stmt->as<ast::Scope>()->codes) this->infer_stmt(x);
+      break;
+
+    // one branch runs, or none without an else: after the if, a slot is
+    // assigned if it is on both ways.
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+
+      this->infer_expr(x->cond);
+
+      auto before = this->assigned;
+
+      this->infer_stmt(x->body);
+
+      auto taken = std::move(this->assigned);
+
+      this->assigned = std::move(before);
+
+      if (x->elseif)
+        this->infer_stmt(x->elseif);
+      else if (x->else_body)
+        this->infer_stmt(x->else_body);
+
+      for (size_t i = 0; i < taken.size(); i++)
+        this->assigned[i] = this->assigned[i] && taken[i];
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+auto TypeInfer::infer_expr(ast::Expr* expr) -> Type {
+  Type type{State::Mixed};
+
+  switch (expr->kind) {
+    case ExprKind::Value:
+      type = {State::Known, expr->as<ast::Value>()->obj->type.kind};
+      break;
+
+    case ExprKind::Variable: {
+      auto slot = expr->as<ast::Variable>()->slot;
+
+      if (this->assigned[slot]) type = this->slots[slot].type;
+      break;
+    }
+
+    case ExprKind::CallFunc: {
+      auto x = expr->as<ast::CallFunc>();
+
+      for (auto&& arg : x->args) this->infer_expr(arg);
+
+      if (x->native < 0) break;
+
+      if (auto k = NativeRegistry::get()[x->native].result;
+          k != TypeKind::None)
+        type = {State::Known, k};
+      break;
+    }
+
+    default: {
+      if (!expr->is_terms()) break;
+
+      auto x = expr->as<ast::Terms>();
+
+      type = this->infer_expr(x->base);
+
+      for (auto&& [_op, term] : x->terms) {
+        auto rhs = this->infer_expr(term);
+
+        if (!ast::is_binop(x->kind) || type.state == State::Mixed ||
+            rhs.state == State::Mixed)
+          type = {State::Mixed};
+        else if (type.state == State::Unset || rhs.state == State::Unset)
+          type = {State::Unset};
+        else if (auto k = ops::result_kind(ast::binop_of(x->kind), type.kind,
+                                           rhs.kind);
+                 k != TypeKind::None)
+          type = {State::Known, k};
+        else
+          type = {State::Mixed};
+      }
+      break;
+    }
+  }
+
+  expr->type = type.state == State::Known ? type.kind : TypeKind::None;
+
+  return type;
+}
+
+// every store to a declared slot is proven to be of that kind.
+auto TypeInfer::check_stmt(ast::Stmt* stmt) -> void {
+  switch (stmt->kind) {
+    case StmtKind::Assign: {
+      auto x = stmt->as<ast::Assign>();
+
+      if (!x->dest->is(ExprKind::Variable)) break;
+
+      auto& S = this->slots[x->dest->as<ast::Variable>()->slot];
+
+      if (S.declared == TypeKind::None || x->source->type == S.declared)
+        break;
+
+      auto name = std::string(type_name(S.declared));
+
+      if (x->source->type == TypeKind::None)
+        this->error(x->token, "value is not proven to be " + name + ".");
+      else
+        this->error(x->token, std::string("cannot assign ") +
+                                  type_name(x->source->type) + " to " +
+                                  name + ".");
+      break;
+    }
+
+    case StmtKind::Scope:
+      for (auto&& x : stmt->as<ast::Scope>()->codes) this->check_stmt(x);
+      break;
+
+    case StmtKind::If: {
+      auto x = stmt->as<ast::If>();
+
+      this->check_stmt(x->body);
+
+      if (x->elseif) this->check_stmt(x->elseif);
+      if (x->else_body) this->check_stmt(x->else_body);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,208 @@
+#include "CTRPluginFramework.hpp"
+
+#include "lua/VM.hpp"
+#include "lua/ObjectOps.hpp"
+#include "lua/Native.hpp"
+
+namespace CTRPluginFramework::lua {
+
+using bc::OpCode;
+
+auto VM::prepare(bc::Chunk const& chunk) -> void {
+  if (this->globals.size() < chunk.globals.size())
+    this->globals.resize(chunk.globals.size());
+
+  if (this->regs.size() < chunk.num_regs)
+    this->regs.resize(chunk.num_regs);
+}
+
+auto VM::remap_globals(std::vector<StringID> const& from,
+                       std::vector<StringID> const& to) -> void {
+  std::vector<Object> old(to.size());
+
+  old.swap(this->globals);
+
+  for (size_t i = 0; i < to.size(); i++) {
+    for (size_t j = 0; j < from.size() && j < old.size(); j++) {
+      if (from[j] == to[i]) {
+        this->globals[i] = old[j];
+        break;
+      }
+    }
+  }
+}
+
+auto VM::run(bc::Chunk const& chunk, u32& steps) -> Status {
+  u32 pc = chunk.body;
+
+  if (this->is_suspended()) {
+    if (this->wait_frames && --this->wait_frames) return Status::Suspended;
+
+    pc = this->resume_pc;
+    this->resume_pc = NOT_SUSPENDED;
+  }
+
+  auto status = this->exec(chunk, pc, steps);
+
+  // only the body's end: the prologue ends in a Halt too.
+  if (status == Status::Done) this->activated = false;
+
+  return status;
+}
+
+auto VM::runtime_error(char const* what) -> void {
+  this->cancel();
+  this->error = what;
+}
+
+auto VM::exec(bc::Chunk const& chunk, u32 start, u32& steps) -> Status {
+  this->prepare(chunk);
+
+  if (this->aot) return this->exec_aot(chunk, start, steps);
+
+  auto pc = chunk.code.data() + start;
+
+  Object* R = this->regs.data();
+  Object* G = this->globals.data();
+  Object const* K = chunk.constants.data();
+
+  NativeFunction const* natives = NativeRegistry::get().data();
+
+#define RK(x) ((x) >= bc::RK_CONST ? K[(x) - bc::RK_CONST] : R[(x)])
+
+  try {
+    while (true) {
+      auto i = *pc++;
+
+      if (i.is_stmt() && steps-- == 0) {
+        steps = 0;
+        this->resume_pc = pc - 1 - chunk.code.data();
+        this->wait_frames = 0;
+        return Status::Preempted;
+      }
+
+      switch (i.op()) {
+        case OpCode::Nop:
+          break;
+
+        case OpCode::LoadK:
+          R[i.a()] = K[i.bx()];
+          break;
+
+        case OpCode::Move:
+          R[i.a()] = R[i.b()];
+          break;
+
+        case OpCode::GetGlobal:
+          R[i.a()] = G[i.bx()];
+          break;
+
+        case OpCode::SetGlobal:
+          G[i.bx()] = R[i.a()];
+          break;
+
+        case OpCode::Mul:
+        case OpCode::Div:
+        case OpCode::Mod:
+        case OpCode::Add:
+        case OpCode::Sub:
+        case OpCode::LShift:
+        case OpCode::RShift:
+        case OpCode::Less:
+        case OpCode::Greater:
+        case OpCode::Equal:
+        case OpCode::NotEqual:
+        case OpCode::BitAnd:
+        case OpCode::BitXor:
+        case OpCode::BitOr:
+          R[i.a()] = binary_op(bc::binop_of(i.op()), RK(i.b()), RK(i.c()));
+          break;
+
+        case OpCode::Jmp:
+          pc += i.sbx();
+          break;
+
+        case OpCode::JmpIfFalse:
+          if (!R[i.a()].v_bool) pc += i.sbx();
+          break;
+
+        case OpCode::CallNative: {
+          NativeCall call{&R[i.a() + 1], i.c(), this->entry,
+                          this->activated, this->writes, this->write_through};
+          R[i.a()] = NativeRegistry::invoke(natives[i.b()], call);
+
+          if (call.suspend) {
+            this->resume_pc = pc - chunk.code.data();
+            this->wait_frames = call.suspend;
+            return Status::Suspended;
+          }
+          break;
+        }
+
+        case OpCode::Halt:
+          return Status::Done;
+
+        // the typed block, no checks on the operands' kinds.
+        default:
+          if (bc::is_typed(i.op()))
+            R[i.a()] = ops::g_typed_kernels[bc::typed_index(i.op())](
+                RK(i.b()), RK(i.c()));
+          break;
+      }
+    }
+  }
+  catch (NativeError const& e) {
+    this->runtime_error(e.what);
+  }
+  catch (...) {
+    this->runtime_error();
+  }
+
+  return Status::Done;
+
+#undef RK
+}
+
+// exec() for code compiled ahead of time: the stop is kept as exec() does.
+auto VM::exec_aot(bc::Chunk const& chunk, u32 start, u32& steps) -> Status {
+  Frame f{
+      .R = this->regs.data(),
+      .G = this->globals.data(),
+      .K = chunk.constants.data(),
+      .call = {nullptr, 0, this->entry, this->activated, this->writes,
+               this->write_through},
+      .pc = start,
+      .steps = steps,
+  };
+
+  try {
+    auto status = this->aot(f);
+
+    switch (status) {
+      case Status::Done:
+        break;
+
+      case Status::Suspended:
+        this->resume_pc = f.pc;
+        this->wait_frames = f.call.suspend;
+        break;
+
+      case Status::Preempted:
+        this->resume_pc = f.pc;
+        this->wait_frames = 0;
+        break;
+    }
+
+    return status;
+  }
+  catch (NativeError const& e) {
+    this->runtime_error(e.what);
+  }
+  catch (...) {
+    this->runtime_error();
+  }
+
+  return Status::Done;
+}
+
+}  // namespace CTRPluginFramework::lua
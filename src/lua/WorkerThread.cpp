@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <utility>
+
+#include "lua/WorkerThread.hpp"
+
+namespace CTRPluginFramework::lua {
+
+#ifdef __3DS__
+
+namespace {
+
+// lowest priority a thread can have.
+constexpr s32 LOWEST_PRIORITY = 0x3F;
+
+}  // namespace
+
+WorkerThread::WorkerThread(WorkerThread&& other) noexcept
+    : thread(std::exchange(other.thread, nullptr)) {}
+
+// the New 3DS's core 2 is idle, core 1 is the system core, which lends
+// a plugin part of its time. -2 is the core of the plugin itself.
+auto WorkerThread::start(void (*fn)(void*), void* arg, size_t stack_size)
+    -> bool {
+  s32 prio = LOWEST_PRIORITY;
+
+  // a larger number is a lower priority: the caller comes first.
+  if (R_SUCCEEDED(svcGetThreadPriority(&prio, CUR_THREAD_HANDLE)))
+    prio = std::min(prio + 1, LOWEST_PRIORITY);
+
+  bool is_new = false;
+
+  APT_CheckNew3DS(&is_new);
+
+  for (int core : {is_new ? 2 : 1, 1, -2})
+    if ((this->thread = threadCreate(fn, arg, stack_size, prio, core, false)))
+      return true;
+
+  return false;
+}
+
+auto WorkerThread::joinable() const -> bool { return this->thread != nullptr; }
+
+auto WorkerThread::join() -> void {
+  if (!this->thread) return;
+
+  threadJoin(this->thread, U64_MAX);
+  threadFree(this->thread);
+
+  this->thread = nullptr;
+}
+
+#else
+
+WorkerThread::WorkerThread(WorkerThread&& other) noexcept
+    : thread(std::move(other.thread)) {}
+
+auto WorkerThread::start(void (*fn)(void*), void* arg, size_t) -> bool {
+  this->thread = std::thread(fn, arg);
+
+  return true;
+}
+
+auto WorkerThread::joinable() const -> bool { return this->thread.joinable(); }
+
+auto WorkerThread::join() -> void {
+  if (this->thread.joinable()) this->thread.join();
+}
+
+#endif
+
+}  // namespace CTRPluginFramework::lua
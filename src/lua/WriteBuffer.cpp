@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cstring>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/PageCache.hpp"
+#include "lua/ReadCache.hpp"
+#include "lua/WriteBuffer.hpp"
+
+namespace CTRPluginFramework::lua {
+
+namespace {
+
+auto by_addr(auto const& p, u32 addr) -> bool { return p.addr < addr; }
+
+}  // namespace
+
+auto WriteBuffer::get() -> WriteBuffer& {
+  static WriteBuffer inst;
+  return inst;
+}
+
+auto WriteBuffer::write(u32 addr, u32 value) -> void {
+  std::lock_guard lock(this->mutex);
+
+  this->stats.issued++;
+
+  auto& P = this->pending;
+  auto it = std::lower_bound(P.begin(), P.end(), addr, by_addr<Pending>);
+
+  if (it != P.end() && it->addr == addr) {
+    it->value = value;
+    this->stats.combined++;
+    return;
+  }
+
+  // overlaps a write at another address: write the older ones out first
+  // so the bytes they share end up in program order.
+  if ((it != P.begin() && (it - 1)->addr + 4 > addr) ||
+      (it != P.end() && it->addr < addr + 4)) {
+    this->flush_locked();
+    it = P.end();
+  }
+
+  P.insert(it, {addr, value});
+}
+
+auto WriteBuffer::peek(u32 addr, u32& value) const -> bool {
+  std::lock_guard lock(this->mutex);
+
+  auto& P = this->pending;
+  auto it = std::lower_bound(P.begin(), P.end(), addr, by_addr<Pending>);
+
+  if (it == P.end() || it->addr != addr) return false;
+
+  value = it->value;
+
+  return true;
+}
+
+auto WriteBuffer::flush_locked() -> void {
+  auto& P = this->pending;
+
+  u8 run[MAX_RUN];
+
+  for (size_t i = 0; i < P.size();) {
+    u32 begin = P[i].addr;
+    u32 size = 0;
+
+    // adjacent writes, in address order.
+    do {
+      std::memcpy(run + size, &P[i].value, 4);
+      size += 4;
+      i++;
+    } while (i < P.size() && P[i].addr == begin + size && size < MAX_RUN);
+
+    if (PageCache::get().write(begin, run, size))
+      this->stats.flushed++;
+    else
+      this->stats.failed++;
+
+    ReadCache::get().invalidate(begin, size);
+  }
+
+  P.clear();
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -0,0 +1,36 @@
+#include <thread>
+
+#include "CTRPluginFramework.hpp"
+
+#include "lua/PageCache.hpp"
+#include "lua/ReadCache.hpp"
+#include "lua/WriteQueue.hpp"
+
+namespace CTRPluginFramework::lua {
+
+auto MemWrite::apply() const -> bool {
+  // both kinds are 4 bytes, `value` holds them as they are in memory.
+  bool ok = PageCache::get().write(this->addr, &this->value, sizeof(u32));
+
+  ReadCache::get().invalidate(this->addr, sizeof(u32));
+
+  return ok;
+}
+
+auto WriteQueue::push(MemWrite const& w) -> void {
+  while (!this->queue.push(w)) {
+    if (this->closed.load()) return;
+
+    std::this_thread::yield();
+  }
+}
+
+auto WriteQueue::drain() -> size_t {
+  size_t count = 0;
+
+  for (MemWrite w; this->queue.pop(w); count++) w.apply();
+
+  return count;
+}
+
+}  // namespace CTRPluginFramework::lua
@@ -5,6 +5,8 @@
 
 namespace CTRPluginFramework {
 
+static lua::Scheduler scheduler;
+
 auto entry_test(MenuEntry* e) -> void {
 
   auto ctx = static_cast<lua::EntryContext*>(e->GetArg());
@@ -12,14 +14,21 @@ auto entry_test(MenuEntry* e) -> void {
   if (!ctx)
     return;
 
-  ctx->eval();
+  // the script itself runs in scheduler.run_frame().
+  if (!ctx->prepare())
+    return;
+
+  // reload the script if it was edited.
+  if (Controller::IsKeysPressed(Key::Select | Key::Y))
+    ctx->request_reload();
 
   if (Controller::IsKeyPressed(Key::X)) {
 
     std::string msg;
 
-    for (auto tok = ctx->get_token(); !tok->is_eof(); tok = tok->next) {
-      msg += tok->get_strview();
+    for (auto&& tok : ctx->get_tokens()) {
+      if (tok.is_eof()) break;
+      msg += tok.get_strview();
       msg += " ";
     }
 
@@ -32,9 +41,14 @@ auto entry_test(MenuEntry* e) -> void {
 
 }
 
-auto init_menu(PluginMenu& menu) -> void {
+// scripts baked in with `make aot` are added with lua::add_aot_entry()
+// instead, and only to the scheduler.
+auto init_menu(PluginMenu& menu, lua::CompileService& service) -> void {
+
+  auto e = lua::add_entry(menu, "test.zlua", new MenuEntry("test", entry_test));
 
-  lua::add_entry(menu, "test.zlua", new MenuEntry("test", entry_test));
+  service.add(e);
+  scheduler.add(e);
 
 }
 
@@ -43,9 +57,7 @@ auto test() -> void {
 
   auto lexer = src.lexer;
 
-  auto token = lexer->lex();
-
-  delete token;
+  lexer->lex();
 }
 
 auto main() -> int {
@@ -59,7 +71,20 @@ auto main() -> int {
 
   menu.SynchronizeWithFrame(true);
 
-  init_menu(menu);
+  // scripts compile in the background while the menu comes up.
+  lua::CompileService service;
+
+  init_menu(menu, service);
+
+  service.start(lua::CompileService::default_workers());
+
+  // the game has run since the last frame, drop what was read then.
+  menu.OnNewFrame = [](Time) {
+    lua::PageCache::get().new_frame();
+    lua::ReadCache::get().new_frame();
+    scheduler.run_frame();
+    lua::WriteBuffer::get().flush();
+  };
 
   menu.Run();
 
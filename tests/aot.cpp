@@ -0,0 +1,115 @@
+//
+// A script run by the VM and compiled ahead of time by zlua2cpp must
+// leave the same trace: the same writes to game memory with the same
+// values, the same notifications, and the same stops under a budget.
+//
+//   aot <script.zlua>
+//
+// Built once per script, with the script's zlua2cpp output as
+// lua::aot::script, see `make check`.
+//
+
+#include "test.hpp"
+
+namespace CTRPluginFramework::lua::aot {
+extern AotScript const script;
+}
+
+using namespace test;
+
+namespace {
+
+constexpr int FRAMES = 40;
+
+// keys held in each frame, repeating.
+constexpr u32 KEYS[] = {0, 1 | 16, 1 | 16, 1 | 32, 1 | 64, 1 | 128, 2, 1 | 2};
+
+auto trace(EntryContext& ctx, u32 budget) -> std::string {
+  std::string out;
+
+  host::reset();
+
+  // the entry is turned on, and off and on again half way.
+  for (int f = 0; f < FRAMES; f++) {
+    if (f == 0 || f == FRAMES / 2) {
+      ctx.entry->Disable();
+      host::activate(ctx.entry);
+    }
+
+    host::game().keys = KEYS[f % std::size(KEYS)];
+
+    u32 steps = budget;
+    auto status = VM::Status::Done;
+
+    bool ran = run_frame(ctx, steps, status);
+
+    out += Utils::Format("frame %d: ", f);
+
+    if (ran)
+      out += Utils::Format("status %d, %u left\n", static_cast<int>(status),
+                           steps);
+    else
+      out += "idle\n";
+
+    for (auto&& w : host::game().writes)
+      out += Utils::Format("  write %08X %u %08X\n", w.addr, w.size, w.value);
+
+    for (auto&& n : host::game().notifications) out += "  notify " + n + "\n";
+
+    host::game().writes.clear();
+    host::game().notifications.clear();
+  }
+
+  return out;
+}
+
+// first line where a and b differ.
+auto first_difference(std::string const& a, std::string const& b)
+    -> std::string {
+  std::istringstream x(a), y(b);
+  std::string p, q;
+
+  while (std::getline(x, p) && std::getline(y, q))
+    if (p != q) return "vm:  " + p + "\naot: " + q;
+
+  return "one trace is shorter";
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <script.zlua>\n", argv[0]);
+    return 2;
+  }
+
+  // built next to the test, so its .zluac stays out of the tree.
+  auto path = std::string(argv[0]) + ".zlua";
+
+  write_file(path, read_file(argv[1]));
+
+  MenuEntry entry("vm", NO_GAME_FUNC);
+  MenuEntry aot_entry("aot", NO_GAME_FUNC);
+
+  for (u32 budget : {1u, 3u, 16u, VM::UNLIMITED}) {
+    EntryContext vm(path, &entry);
+    std::unique_ptr<EntryContext> aot(
+        make_aot_context(lua::aot::script, &aot_entry));
+
+    CHECK(aot != nullptr);
+
+    if (!aot) break;
+
+    auto expected = trace(vm, budget);
+    auto actual = trace(*aot, budget);
+
+    CHECK(vm.is_ready());
+    CHECK(expected == actual);
+
+    if (expected != actual)
+      std::fprintf(stderr, "budget %u:\n%s\n", budget,
+                   first_difference(expected, actual).c_str());
+  }
+
+  return result(argv[1]);
+}
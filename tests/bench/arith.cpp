@@ -0,0 +1,59 @@
+//
+// An arithmetic-heavy script on the VM: integer, bit and float ops on
+// globals, with the result of every statement stored back. Mostly moves
+// of Objects between globals, registers and constants. Only operators
+// that every VM so far compiles, to compare builds before and after.
+//
+
+#include "bench.hpp"
+
+using namespace bench;
+
+namespace {
+
+constexpr u32 FRAMES = 20000;
+
+// statements of the body: 6 per block.
+constexpr int BLOCKS = 100;
+
+constexpr char BLOCK[] = R"(
+a = a + b - 1
+d = a & 255
+b = b << 1
+b = b >> 1 | 3
+c = c + 1.5 - 0.5
+d = d + a - b
+)";
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  // the prologue sets them once.
+  std::string text = "a = 1\nb = 2\nc = 3.0\nd = 0\n";
+
+  for (int i = 0; i < BLOCKS; i++) text += BLOCK;
+
+  write_file(path, text);
+
+  MenuEntry entry("arith", NO_GAME_FUNC);
+  EntryContext ctx(path, &entry);
+
+  host::activate(&entry);
+
+  if (!ctx.prepare()) {
+    std::fprintf(stderr, "%s: failed to build.\n", path.c_str());
+    return 1;
+  }
+
+  auto ns = ns_per_call(FRAMES, [&] {
+    u32 steps = VM::UNLIMITED;
+    ctx.step(steps);
+  });
+
+  std::printf("arith: %d statements, sizeof(Object) %zu, %.0f ns/frame\n",
+              BLOCKS * 6, sizeof(Object), ns);
+
+  return result("arith");
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+#include "../test.hpp"
+
+//
+// Shared by the host benchmarks, tests/bench/*.cpp, run by `make bench`.
+// Host numbers only compare one build with another; the 3DS is an order
+// of magnitude slower.
+//
+namespace bench {
+
+using namespace test;
+
+constexpr int ROUNDS = 5;
+
+// nanoseconds per call of f, the best of ROUNDS rounds of n calls.
+template <typename F>
+auto ns_per_call(u32 n, F&& f) -> double {
+  double best = 1e300;
+
+  for (int r = 0; r < ROUNDS; r++) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (u32 i = 0; i < n; i++) f();
+
+    std::chrono::duration<double, std::nano> t =
+        std::chrono::steady_clock::now() - start;
+
+    best = std::min(best, t.count() / n);
+  }
+
+  return best;
+}
+
+// the steps of EntryContext::build() that give the AST, no cache.
+inline auto parse(SourceFile& src) -> bool {
+  if (!src.read() || !src.lexer->lex()) return false;
+
+  EntryContext::parse(src);
+
+  if (!src.program) return false;
+
+  Optimizer(&src).optimize(src.program);
+
+  return TypeInfer(&src).infer(src.program);
+}
+
+}  // namespace bench
@@ -0,0 +1,87 @@
+//
+// CompileService building 16 scripts with 1, 2 and 4 workers, from the
+// read to the stored cache. The speedup is bounded by the cores the
+// host gives the benchmark; the New 3DS has two spare ones at boot.
+//
+
+#include <thread>
+
+#include "bench.hpp"
+
+using namespace bench;
+
+namespace {
+
+constexpr int SCRIPTS = 16;
+
+// copies of coord-mod per script, about 14 KB.
+constexpr int COPIES = 32;
+
+// ms from start() to the last entry published, best of ROUNDS.
+auto build_ms(std::vector<std::string> const& paths, unsigned workers)
+    -> double {
+  double best = 1e300;
+
+  for (int r = 0; r < ROUNDS; r++) {
+    std::vector<std::unique_ptr<MenuEntry>> entries;
+    std::vector<std::unique_ptr<EntryContext>> contexts;
+
+    CompileService service;
+
+    for (auto&& path : paths) {
+      std::remove((path + "c").c_str());
+
+      auto& e = entries.emplace_back(new MenuEntry(path, NO_GAME_FUNC));
+      auto& ctx = contexts.emplace_back(new EntryContext(path, e.get()));
+
+      e->SetArg(ctx.get());
+      service.add(e.get());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    service.start(workers);
+    service.wait();
+
+    std::chrono::duration<double, std::milli> t =
+        std::chrono::steady_clock::now() - start;
+
+    best = std::min(best, t.count());
+
+    for (auto&& ctx : contexts) CHECK(ctx->is_ready());
+  }
+
+  return best;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto body = read_file("examples/coord-mod.zlua") + "\n";
+
+  std::string text;
+
+  for (int i = 0; i < COPIES; i++) text += body;
+
+  std::vector<std::string> paths;
+
+  for (int i = 0; i < SCRIPTS; i++) {
+    paths.push_back(Utils::Format("%s.%d.zlua", argv[0], i));
+    write_file(paths.back(), text);
+  }
+
+  double one = build_ms(paths, 1);
+
+  std::printf("compile %d x %zu KB, %u cores: 1 worker %.2f ms", SCRIPTS,
+              text.size() / 1024, std::thread::hardware_concurrency(), one);
+
+  for (unsigned workers : {2u, 4u}) {
+    double ms = build_ms(paths, workers);
+
+    std::printf(", %u workers %.2f ms (%.2fx)", workers, ms, one / ms);
+  }
+
+  std::printf("\n");
+
+  return result("compile");
+}
@@ -0,0 +1,71 @@
+//
+// Loading a 100 KB script: SourceFile::read(), one sized read into an
+// immutable buffer, against the line at a time read it replaced, where
+// each line was appended to a growing std::string.
+//
+// On the host the file is in the page cache; on the SD card every read
+// also waits for the card, which favours one read more.
+//
+
+#include "bench.hpp"
+
+using namespace bench;
+
+namespace {
+
+constexpr size_t SIZE = 100 * 1024;
+
+constexpr u32 LOADS = 500;
+
+// the old SourceFile::read(), with stdio for LineReader.
+auto read_by_line(std::string const& path) -> std::string {
+  std::string data;
+  FILE* fp = std::fopen(path.c_str(), "rb");
+
+  if (!fp) return data;
+
+  char line[256];
+
+  while (std::fgets(line, sizeof(line), fp)) {
+    std::string s(line);
+
+    if (!s.empty() && s.back() == '\n') s.pop_back();
+
+    s.push_back('\n');
+    data.append(s);
+  }
+
+  std::fclose(fp);
+
+  return data;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+  auto body = read_file("examples/coord-mod.zlua");
+
+  // the line at a time read ends every line, the last one too.
+  if (body.back() != '\n') body += '\n';
+
+  std::string text;
+
+  while (text.size() < SIZE) text += body;
+
+  write_file(path, text);
+
+  SourceFile src(path);
+
+  CHECK(src.read() && src.data.size() == text.size());
+  CHECK(read_by_line(path).size() == text.size());
+
+  auto line_ns = ns_per_call(LOADS, [&] { read_by_line(path); });
+  auto once_ns = ns_per_call(LOADS, [&] { src.read(); });
+
+  std::printf("load %zu KB: by line %.1f us, at once %.1f us, %.2fx\n",
+              text.size() / 1024, line_ns / 1000, once_ns / 1000,
+              line_ns / once_ns);
+
+  return result("load");
+}
@@ -0,0 +1,83 @@
+//
+// One frame of examples/coord-mod.zlua on the VM against the old tree
+// walk, ASTEvaluator, with the keys cycling through every branch.
+//
+
+#include "bench.hpp"
+#include "lua/Eval.hpp"
+
+using namespace bench;
+
+namespace {
+
+constexpr u32 FRAMES = 200000;
+
+constexpr u32 KEYS[] = {0, 1 | 16, 1 | 32, 1 | 64, 1 | 128};
+
+u32 frame = 0;
+
+// the work around every frame, the same for both.
+auto new_frame() -> void {
+  host::game().keys = KEYS[frame++ % std::size(KEYS)];
+  host::game().writes.clear();
+  host::game().notifications.clear();
+
+  PageCache::get().new_frame();
+  ReadCache::get().new_frame();
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  write_file(path, read_file(argc > 1 ? argv[1] : "examples/coord-mod.zlua"));
+
+  MenuEntry entry("vm_ast", NO_GAME_FUNC);
+
+  SourceFile src(path);
+
+  if (!parse(src)) {
+    std::fprintf(stderr, "%s: failed to build.\n", path.c_str());
+    return 1;
+  }
+
+  ASTEvaluator ast(&src, &entry);
+
+  EntryContext ctx(path, &entry);
+
+  host::activate(&entry);
+
+  if (!ctx.prepare()) {
+    std::fprintf(stderr, "%s: failed to build.\n", path.c_str());
+    return 1;
+  }
+
+  // taken off both, it is mostly the host's simulated memory.
+  auto frame_ns = ns_per_call(FRAMES, [&] {
+    new_frame();
+    WriteBuffer::get().flush();
+  });
+
+  auto ast_ns = ns_per_call(FRAMES, [&] {
+    new_frame();
+    ast.eval(src.program);
+    WriteBuffer::get().flush();
+  });
+
+  auto vm_ns = ns_per_call(FRAMES, [&] {
+    new_frame();
+    u32 steps = VM::UNLIMITED;
+    ctx.step(steps);
+    WriteBuffer::get().flush();
+  });
+
+  ast_ns -= frame_ns;
+  vm_ns -= frame_ns;
+
+  std::printf("%s: ASTEvaluator %.0f ns/frame, VM %.0f ns/frame, %.2fx\n",
+              argc > 1 ? argv[1] : "coord-mod.zlua", ast_ns, vm_ns,
+              ast_ns / vm_ns);
+
+  return 0;
+}
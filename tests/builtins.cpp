@@ -0,0 +1,75 @@
+//
+// Builtins at the edges: what readf() and writef() report for memory the
+// game does not have, and wait() with no frames to wait.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+// 0x10000000 is outside the host's game memory.
+constexpr char SCRIPT[] = R"(
+bad = readf(0x10000000)
+good = readf(0x33099E50)
+
+if bad != bad then
+  notify("readf nan")
+end
+
+if good == good then
+  notify("readf ok")
+end
+
+notify(writef(0x10000000, 1.0))
+notify(writef(0x33099E50, 2.0))
+)";
+
+auto run(std::string const& path, std::string const& text)
+    -> std::vector<std::string> {
+  write_file(path, text);
+
+  MenuEntry entry("builtins", NO_GAME_FUNC);
+  EntryContext ctx(path, &entry);
+
+  host::reset();
+  host::activate(&entry);
+
+  u32 steps = VM::UNLIMITED;
+  auto status = VM::Status::Done;
+
+  CHECK(run_frame(ctx, steps, status));
+
+  return host::game().notifications;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  auto notes = run(path, SCRIPT);
+
+  CHECK(notes.size() == 4);
+
+  if (notes.size() == 4) {
+    CHECK(notes[0] == "readf nan");
+    CHECK(notes[1] == "readf ok");
+    CHECK(notes[2] == "false");
+    CHECK(notes[3] == "true");
+  }
+
+  // only the valid write reaches the game.
+  CHECK(host::game().writes.size() == 1);
+
+  // no unary minus in the language.
+  for (auto frames : {"0", "0 - 1"}) {
+    notes = run(path, std::string("wait(") + frames + ")\nnotify(\"woke\")\n");
+
+    CHECK(notes.size() == 1);
+    CHECK(!notes.empty() && notes[0] == "wait: frames must be > 0");
+  }
+
+  return result("builtins");
+}
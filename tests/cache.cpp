@@ -0,0 +1,177 @@
+//
+// ChunkCache::load() takes a .zluac only if every instruction of it is
+// one the VM can run without going out of its registers, constants,
+// globals or code. Each case breaks one field of a good cache.
+//
+
+#include <cstring>
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+// the u32s of ChunkCache::Header used here, then code follows.
+enum HeaderField {
+  BODY = 4,
+  NUM_REGS = 5,
+  CODE_COUNT = 6,
+  CONST_COUNT = 7,
+  GLOBAL_COUNT = 8,
+  HEADER_SIZE = 12,
+};
+
+// the file as u32s, with the string bytes that may not fill the last one.
+struct Words {
+  std::vector<u32> w;
+  std::string tail;
+
+  auto operator[](size_t i) -> u32& { return w[i]; }
+  auto size() const -> size_t { return w.size(); }
+};
+
+auto read_words(std::string const& path) -> Words {
+  auto bytes = read_file(path);
+  Words w;
+
+  w.w.resize(bytes.size() / 4);
+  std::memcpy(w.w.data(), bytes.data(), w.size() * 4);
+  w.tail = bytes.substr(w.size() * 4);
+
+  return w;
+}
+
+auto write_words(std::string const& path, Words const& w) -> void {
+  std::ofstream out(path, std::ios::binary);
+
+  out.write(reinterpret_cast<char const*>(w.w.data()), w.size() * 4);
+  out << w.tail;
+}
+
+auto loads(std::string const& path) -> bool {
+  SourceFile src(path);
+
+  if (!src.read()) return false;
+
+  std::unique_ptr<bc::Chunk> chunk(ChunkCache(&src).load());
+
+  return chunk != nullptr;
+}
+
+// index in `w` of the first instruction with `op`, coord-mod has them all.
+auto find(Words& w, bc::OpCode op) -> size_t {
+  for (u32 i = 0; i < w[CODE_COUNT]; i++)
+    if (bc::Instruction{w[HEADER_SIZE + i]}.op() == op) return HEADER_SIZE + i;
+
+  CHECK(!"no such instruction");
+
+  return 0;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+  auto cache = path + "c";
+
+  write_file(path, read_file("examples/coord-mod.zlua"));
+
+  // the steps of EntryContext::build(), then the store.
+  {
+    SourceFile src(path);
+
+    CHECK(src.read() && src.lexer->lex());
+
+    EntryContext::parse(src);
+
+    CHECK(src.program != nullptr);
+
+    if (!src.program) return result("cache");
+
+    Optimizer(&src).optimize(src.program);
+
+    CHECK(TypeInfer(&src).infer(src.program));
+
+    src.chunk = src.compiler->compile(src.program);
+
+    CHECK(src.chunk && ChunkCache(&src).store(*src.chunk));
+  }
+
+  Words good = read_words(cache);
+
+  CHECK(good.size() > HEADER_SIZE);
+  CHECK(loads(path));
+
+  if (good.size() <= HEADER_SIZE) return result("cache");
+
+  u32 num_regs = good[NUM_REGS];
+  u32 consts = HEADER_SIZE + good[CODE_COUNT];
+
+  auto rejects = [&](char const* what, auto&& change) {
+    Words w = good;
+    change(w);
+    write_words(cache, w);
+
+    if (loads(path)) {
+      std::fprintf(stderr, "loaded with %s\n", what);
+      failures++;
+    }
+  };
+
+  using bc::Instruction;
+  using bc::OpCode;
+
+  rejects("an unknown opcode",
+          [&](Words& w) { w[find(w, OpCode::LoadK)] = 0x7F; });
+
+  rejects("LoadK past the constants", [&](Words& w) {
+    auto at = find(w, OpCode::LoadK);
+    auto i = Instruction{w[at]};
+    w[at] = Instruction::abx(OpCode::LoadK, i.a(), w[CONST_COUNT]).raw;
+  });
+
+  rejects("GetGlobal past the globals", [&](Words& w) {
+    auto at = find(w, OpCode::GetGlobal);
+    auto i = Instruction{w[at]};
+    w[at] = Instruction::abx(OpCode::GetGlobal, i.a(), w[GLOBAL_COUNT]).raw;
+  });
+
+  rejects("a register past num_regs", [&](Words& w) {
+    auto at = find(w, OpCode::LoadK);
+    auto i = Instruction{w[at]};
+    w[at] = Instruction::abx(OpCode::LoadK, num_regs, i.bx()).raw;
+  });
+
+  rejects("a call past num_regs", [&](Words& w) {
+    auto at = find(w, OpCode::CallNative);
+    auto i = Instruction{w[at]};
+    w[at] = Instruction::abc(OpCode::CallNative, num_regs - i.c(), i.b(),
+                             i.c() + 1)
+                .raw;
+  });
+
+  rejects("a jump out of the code", [&](Words& w) {
+    auto at = find(w, OpCode::JmpIfFalse);
+    auto i = Instruction{w[at]};
+    w[at] = Instruction::asbx(OpCode::JmpIfFalse, i.a(), w[CODE_COUNT]).raw;
+  });
+
+  rejects("a jump from the body into the prologue", [&](Words& w) {
+    auto at = find(w, OpCode::JmpIfFalse);
+    auto i = Instruction{w[at]};
+    w[at] = Instruction::asbx(OpCode::JmpIfFalse, i.a(),
+                              static_cast<int>(w[BODY]) -
+                                  static_cast<int>(at - HEADER_SIZE) - 2)
+                .raw;
+  });
+
+  rejects("a constant of no kind", [&](Words& w) { w[consts] = 6; });
+
+  // the good one again, nothing else was wrong.
+  write_words(cache, good);
+
+  CHECK(loads(path));
+
+  return result("cache");
+}
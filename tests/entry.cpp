@@ -0,0 +1,139 @@
+//
+// EntryContext across frames: on_enabled() is true on the first run
+// after the entry is turned on, until the body has run through once,
+// even when that run waits for a background build. A hot reload swaps
+// in a new build, or reports why it failed.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+// a prologue, then a body of two statements.
+constexpr char SCRIPT[] = R"(
+x = 1
+
+if on_enabled() then
+  notify("enabled")
+end
+
+if on_enabled() then
+  notify("still enabled")
+end
+)";
+
+auto notes() -> std::vector<std::string>& {
+  return host::game().notifications;
+}
+
+// the prologue's Halt does not end the activation.
+auto activated_once(std::string const& path, u32 budget) -> void {
+  MenuEntry entry("once", NO_GAME_FUNC);
+  EntryContext ctx(path, &entry);
+
+  host::reset();
+
+  for (int on = 0; on < 2; on++) {
+    entry.Disable();
+    host::activate(&entry);
+
+    // one statement per frame when budget is 1.
+    for (int f = 0; f < 4; f++) {
+      u32 steps = budget;
+      auto status = VM::Status::Done;
+
+      CHECK(run_frame(ctx, steps, status));
+    }
+
+    CHECK(notes().size() == 2);
+    CHECK(notes().size() == 2 && notes()[0] == "enabled");
+    CHECK(notes().size() == 2 && notes()[1] == "still enabled");
+
+    notes().clear();
+  }
+}
+
+// turned on while its build is still queued in a CompileService.
+auto activated_while_queued(std::string const& path) -> void {
+  MenuEntry entry("queued", NO_GAME_FUNC);
+  EntryContext ctx(path, &entry);
+
+  entry.SetArg(&ctx);
+
+  CompileService service;
+
+  service.add(&entry);
+
+  host::reset();
+  host::activate(&entry);
+
+  u32 steps = VM::UNLIMITED;
+  auto status = VM::Status::Done;
+
+  CHECK(!run_frame(ctx, steps, status));
+
+  service.start(1);
+  service.wait();
+
+  CHECK(run_frame(ctx, steps, status));
+
+  CHECK(notes().size() == 2 && notes()[0] == "enabled");
+}
+
+// a failed reload reports its own message, then a good one swaps in.
+auto reload(std::string const& path) -> void {
+  MenuEntry entry("reload", NO_GAME_FUNC);
+  EntryContext ctx(path, &entry);
+
+  host::reset();
+  host::activate(&entry);
+
+  u32 steps = VM::UNLIMITED;
+  auto status = VM::Status::Done;
+
+  CHECK(run_frame(ctx, steps, status));
+
+  notes().clear();
+
+  auto reload_to = [&](std::string const& text) {
+    write_file(path, text);
+
+    ctx.request_reload();
+
+    while (!ctx.reload_done.load(std::memory_order_acquire))
+      std::this_thread::yield();
+
+    CHECK(run_frame(ctx, steps, status));
+  };
+
+  reload_to("if then\n");
+
+  CHECK(notes().size() == 1 && notes()[0] == path + ": failed to parse.");
+  CHECK(ctx.failure.empty());
+
+  notes().clear();
+
+  reload_to(std::string(SCRIPT) + "notify(\"new\")\n");
+
+  CHECK(notes().size() == 2 && notes()[0] == path + ": reloaded.");
+  CHECK(notes().size() == 2 && notes()[1] == "new");
+
+  write_file(path, SCRIPT);
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  write_file(path, SCRIPT);
+
+  activated_once(path, VM::UNLIMITED);
+  activated_once(path, 1);
+  activated_while_queued(path);
+  reload(path);
+
+  return result("entry");
+}
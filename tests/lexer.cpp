@@ -0,0 +1,93 @@
+//
+// Lexer::lex_number: the literal's type and value, and an error for a
+// value its type cannot hold or for a malformed literal.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+struct Lexed {
+  bool ok = false;
+  std::string error;  // the first one
+  Token tok;
+};
+
+// `x = <literal>`
+auto lex(std::string const& path, std::string const& literal) -> Lexed {
+  write_file(path, "x = " + literal + "\n");
+
+  SourceFile src(path);
+  Lexed r;
+
+  if (!src.read()) return r;
+
+  r.ok = src.lexer->lex();
+
+  if (!src.errors.empty()) r.error = src.errors[0]->msg;
+
+  if (src.tokens.size() > 2) r.tok = src.tokens[2];
+
+  return r;
+}
+
+auto is_literal(Lexed const& r, TokenLiterals kind) -> bool {
+  return r.tok.kind == TokenKind::Literal && r.tok.literal == kind;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  auto r = lex(path, "0x33099E50");
+
+  CHECK(r.ok && is_literal(r, TokenLiterals::U32));
+  CHECK(r.tok.v_u32 == 0x33099E50);
+
+  r = lex(path, "0xFFFFFFFF");
+
+  CHECK(r.ok && is_literal(r, TokenLiterals::U32));
+  CHECK(r.tok.v_u32 == 0xFFFFFFFF);
+
+  r = lex(path, "0x100000000");
+
+  CHECK(!r.ok && r.error == "integer literal is too large for u32.");
+
+  r = lex(path, "0xFFFFFFFFFFFFFFFFUL");
+
+  CHECK(r.ok && is_literal(r, TokenLiterals::U64));
+  CHECK(r.tok.v_u64 == 0xFFFFFFFFFFFFFFFF);
+
+  r = lex(path, "2147483647");
+
+  CHECK(r.ok && is_literal(r, TokenLiterals::I32));
+  CHECK(r.tok.v_i32 == 2147483647);
+
+  r = lex(path, "2147483648");
+
+  CHECK(!r.ok && r.error == "integer literal is too large for i32.");
+
+  r = lex(path, "9223372036854775808LL");
+
+  CHECK(!r.ok && r.error == "integer literal is too large for i64.");
+
+  for (auto bad : {"0b102", "12abc"}) {
+    r = lex(path, bad);
+
+    CHECK(!r.ok && r.error == "invalid digit or suffix in numeric literal.");
+  }
+
+  r = lex(path, "0x");
+
+  CHECK(!r.ok && r.error == "expected digits after the prefix.");
+
+  r = lex(path, "1.5f");
+
+  CHECK(r.ok && is_literal(r, TokenLiterals::Float));
+  CHECK(r.tok.v_float == 1.5f);
+
+  return result("lexer");
+}
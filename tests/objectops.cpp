@@ -0,0 +1,149 @@
+//
+// The binary operator table, cell by cell: the kind each pair of
+// operand kinds is promoted to, and the edges of the integer math.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+auto i32_(i32 v) -> Object {
+  Object x(TypeKind::I32);
+  x.v_i32 = v;
+  return x;
+}
+
+auto u32_(u32 v) -> Object {
+  Object x(TypeKind::U32);
+  x.v_u32 = v;
+  return x;
+}
+
+auto float_(float v) -> Object {
+  Object x(TypeKind::Float);
+  x.v_float = v;
+  return x;
+}
+
+auto str_(char const* s) -> Object {
+  Object x(TypeKind::Str);
+  x.v_str = Interner::get().intern(s);
+  return x;
+}
+
+auto is_bool(Object const& x, bool v) -> bool {
+  return x.type.kind == TypeKind::Bool && x.v_bool == v;
+}
+
+auto ints() -> void {
+  auto r = binary_op(BinOp::Add, i32_(1), u32_(2));
+
+  CHECK(r.type.kind == TypeKind::U32 && r.v_u32 == 3);
+
+  // wraps in u32.
+  r = binary_op(BinOp::Sub, u32_(1), i32_(2));
+
+  CHECK(r.type.kind == TypeKind::U32 && r.v_u32 == 0xFFFFFFFF);
+
+  r = binary_op(BinOp::Mul, i32_(-3), i32_(4));
+
+  CHECK(r.type.kind == TypeKind::I32 && r.v_i32 == -12);
+
+  CHECK(is_bool(binary_op(BinOp::Less, i32_(-1), i32_(0)), true));
+
+  // -1 is 0xFFFFFFFF as u32.
+  CHECK(is_bool(binary_op(BinOp::Less, i32_(-1), u32_(0)), false));
+
+  // the left operand's kind.
+  r = binary_op(BinOp::LShift, u32_(1), i32_(33));
+
+  CHECK(r.type.kind == TypeKind::U32 && r.v_u32 == 2);
+
+  r = binary_op(BinOp::BitOr, i32_(1), u32_(16));
+
+  CHECK(r.type.kind == TypeKind::U32 && r.v_u32 == 17);
+}
+
+auto floats() -> void {
+  auto r = binary_op(BinOp::Add, i32_(3), float_(0.5f));
+
+  CHECK(r.type.kind == TypeKind::Float && r.v_float == 3.5f);
+
+  r = binary_op(BinOp::Mul, float_(0.5f), u32_(4));
+
+  CHECK(r.type.kind == TypeKind::Float && r.v_float == 2.0f);
+
+  CHECK(is_bool(binary_op(BinOp::Equal, i32_(2), float_(2.0f)), true));
+
+  // integers only.
+  CHECK(binary_op(BinOp::BitAnd, float_(1.0f), i32_(1)).type.kind ==
+        TypeKind::None);
+  CHECK(binary_op(BinOp::LShift, i32_(1), float_(1.0f)).type.kind ==
+        TypeKind::None);
+}
+
+// strings only compare, and only with strings.
+auto strings() -> void {
+  CHECK(is_bool(binary_op(BinOp::Equal, str_("a"), str_("a")), true));
+  CHECK(is_bool(binary_op(BinOp::Equal, str_("a"), str_("b")), false));
+  CHECK(is_bool(binary_op(BinOp::NotEqual, str_("a"), str_("b")), true));
+
+  CHECK(is_bool(binary_op(BinOp::Equal, str_("1"), i32_(1)), false));
+  CHECK(is_bool(binary_op(BinOp::NotEqual, i32_(1), str_("1")), true));
+
+  CHECK(binary_op(BinOp::Add, str_("a"), str_("b")).type.kind ==
+        TypeKind::None);
+  CHECK(binary_op(BinOp::Less, str_("a"), str_("b")).type.kind ==
+        TypeKind::None);
+}
+
+// integer division by 0 gives 0, so does INT_MIN % -1.
+auto divide_by_zero() -> void {
+  auto r = binary_op(BinOp::Div, i32_(7), i32_(0));
+
+  CHECK(r.type.kind == TypeKind::I32 && r.v_i32 == 0);
+
+  r = binary_op(BinOp::Mod, u32_(7), u32_(0));
+
+  CHECK(r.type.kind == TypeKind::U32 && r.v_u32 == 0);
+
+  r = binary_op(BinOp::Div, i32_(INT32_MIN), i32_(-1));
+
+  CHECK(r.type.kind == TypeKind::I32 && r.v_i32 == INT32_MIN);
+
+  r = binary_op(BinOp::Mod, i32_(INT32_MIN), i32_(-1));
+
+  CHECK(r.type.kind == TypeKind::I32 && r.v_i32 == 0);
+}
+
+// None equals None and nothing else; every other operator gives None.
+auto none() -> void {
+  Object none;
+
+  CHECK(is_bool(binary_op(BinOp::Equal, none, none), true));
+  CHECK(is_bool(binary_op(BinOp::NotEqual, none, none), false));
+
+  for (auto x : {i32_(0), u32_(0), float_(0), str_("")}) {
+    CHECK(is_bool(binary_op(BinOp::Equal, none, x), false));
+    CHECK(is_bool(binary_op(BinOp::Equal, x, none), false));
+    CHECK(is_bool(binary_op(BinOp::NotEqual, x, none), true));
+
+    CHECK(binary_op(BinOp::Add, x, none).type.kind == TypeKind::None);
+  }
+
+  CHECK(binary_op(BinOp::Less, none, none).type.kind == TypeKind::None);
+}
+
+}  // namespace
+
+auto main() -> int {
+  ints();
+  floats();
+  strings();
+  divide_by_zero();
+  none();
+
+  return result("objectops");
+}
@@ -0,0 +1,96 @@
+//
+// Optimizer on a coord-mod style script: key masks built from constant
+// globals fold into one constant, a constant condition keeps only its
+// live branch, and a global that is also assigned a value read at run
+// time is left alone.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+constexpr char SCRIPT[] = R"(
+KEY_A = 1
+KEY_DR = 1 << 4
+speed = 3.0
+speed = readf(0x33099E50)
+
+if true then
+  notify(KEY_A | KEY_DR)
+else
+  notify("dead")
+end
+
+writef(0x33099E50, speed)
+)";
+
+auto call_of(ast::Stmt* stmt) -> ast::CallFunc* {
+  if (!stmt->is(ast::StmtKind::Expr)) return nullptr;
+
+  auto expr = stmt->as<ast::ExprStatement>()->expr;
+
+  return expr->is(ast::ExprKind::CallFunc) ? expr->as<ast::CallFunc>()
+                                           : nullptr;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  write_file(path, SCRIPT);
+
+  SourceFile src(path);
+
+  CHECK(src.read() && src.lexer->lex());
+
+  EntryContext::parse(src);
+
+  CHECK(src.program);
+
+  if (!src.program) return result("optimizer");
+
+  //   KEY_A = 1                   3 nodes, dropped
+  //   KEY_DR = 1 << 4             5, dropped
+  //   if true .. else .. end     12, 4 left as the body's scope
+  //   the two stores to speed and the writef stay.
+  CHECK(Optimizer(&src).optimize(src.program) == 3 + 5 + 12 - 4);
+
+  auto& codes = src.program->codes;
+
+  CHECK(codes.size() == 4);
+
+  if (codes.size() != 4) return result("optimizer");
+
+  // speed = 3.0, speed = readf(..)
+  CHECK(codes[0]->is(ast::StmtKind::Assign));
+  CHECK(codes[1]->is(ast::StmtKind::Assign));
+
+  // only the `then` body is left, its mask is the constant 17.
+  CHECK(codes[2]->is(ast::StmtKind::Scope));
+
+  if (codes[2]->is(ast::StmtKind::Scope)) {
+    auto& body = codes[2]->as<ast::Scope>()->codes;
+    auto call = body.size() == 1 ? call_of(body[0]) : nullptr;
+
+    CHECK(call && call->args.size() == 1);
+
+    if (call && call->args.size() == 1) {
+      auto arg = call->args[0];
+
+      CHECK(arg->is(ast::ExprKind::Value));
+      CHECK(arg->is(ast::ExprKind::Value) &&
+            arg->as<ast::Value>()->obj->v_i32 == (1 | 1 << 4));
+    }
+  }
+
+  // `speed` is read as the variable.
+  auto call = call_of(codes[3]);
+
+  CHECK(call && call->args.size() == 2 &&
+        call->args[1]->is(ast::ExprKind::Variable));
+
+  return result("optimizer");
+}
@@ -0,0 +1,128 @@
+//
+// PageCache: one Process::CheckAddress per page and permission for
+// `interval` frames, a fresh one after. A copy that fails on a page the
+// cache took as mapped drops the page at once.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+constexpr u32 PAGE = 0x33099000;
+constexpr u32 NEXT = PAGE + PageCache::PAGE_SIZE;
+
+auto cache() -> PageCache& { return PageCache::get(); }
+
+auto checks() -> u32 { return host::game().checks; }
+
+// nothing known, a page stays so for `interval` frames.
+auto fresh(u32 interval) -> void {
+  host::reset();
+
+  cache().set_interval(1);
+  cache().new_frame();
+  cache().set_interval(interval);
+}
+
+auto one_check_per_page() -> void {
+  fresh(PageCache::DEFAULT_INTERVAL);
+
+  auto before = cache().get_stats();
+
+  CHECK(cache().check(PAGE, MEMPERM_READ));
+  CHECK(cache().check(PAGE + 4, MEMPERM_READ));
+  CHECK(cache().check(NEXT - 4, MEMPERM_READ));
+  CHECK(checks() == 1);
+
+  CHECK(cache().check(NEXT, MEMPERM_READ));
+  CHECK(checks() == 2);
+
+  // a read crossing into NEXT checks both pages, both are known.
+  u32 v;
+
+  CHECK(cache().read(NEXT - 2, &v, sizeof(v)));
+  CHECK(checks() == 2);
+
+  auto after = cache().get_stats();
+
+  CHECK(after.queries - before.queries == 2);
+  CHECK(after.hits - before.hits == 4);
+}
+
+auto requery_after_interval() -> void {
+  fresh(3);
+
+  CHECK(cache().check(PAGE, MEMPERM_READ));
+
+  for (int f = 1; f < 3; f++) {
+    cache().new_frame();
+
+    CHECK(cache().check(PAGE, MEMPERM_READ));
+    CHECK(checks() == 1);
+  }
+
+  cache().new_frame();
+
+  CHECK(cache().check(PAGE, MEMPERM_READ));
+  CHECK(checks() == 2);
+}
+
+// the page went away after it was checked.
+auto fault(bool write) -> void {
+  fresh(PageCache::DEFAULT_INTERVAL);
+
+  u32 perm = write ? MEMPERM_WRITE : MEMPERM_READ;
+  u32 v = 0;
+
+  CHECK(cache().check(PAGE, perm));
+
+  host::game().unmapped.insert(PAGE / host::Game::PAGE_SIZE);
+
+  auto before = cache().get_stats();
+
+  CHECK(!(write ? cache().write(PAGE, &v, sizeof(v))
+                : cache().read(PAGE, &v, sizeof(v))));
+  CHECK(cache().get_stats().faults - before.faults == 1);
+  CHECK(checks() == 1);
+
+  CHECK(!cache().check(PAGE, perm));
+  CHECK(checks() == 2);
+}
+
+// each permission mask is its own bit, 1 << (perm & 7).
+auto perms() -> void {
+  fresh(PageCache::DEFAULT_INTERVAL);
+
+  host::game().read_only.insert(PAGE / host::Game::PAGE_SIZE);
+
+  for (int i = 0; i < 2; i++) {
+    CHECK(cache().check(PAGE, MEMPERM_READ));
+    CHECK(!cache().check(PAGE, MEMPERM_WRITE));
+    CHECK(!cache().check(PAGE, MEMPERM_READ | MEMPERM_WRITE));
+
+    CHECK(cache().check(NEXT, MEMPERM_WRITE));
+    CHECK(cache().check(NEXT, MEMPERM_READ | MEMPERM_WRITE));
+  }
+
+  CHECK(checks() == 5);
+
+  u32 v = 0;
+
+  CHECK(!cache().write(PAGE, &v, sizeof(v)));
+  CHECK(cache().write(NEXT, &v, sizeof(v)));
+  CHECK(host::game().writes.size() == 1);
+}
+
+}  // namespace
+
+auto main() -> int {
+  one_check_per_page();
+  requery_after_interval();
+  fault(false);
+  fault(true);
+  perms();
+
+  return result("pagecache");
+}
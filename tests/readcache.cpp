@@ -0,0 +1,103 @@
+//
+// ReadCache: the first read of a frame loads its whole BLOCK with one
+// copy out of the game, later reads of the block in that frame are
+// served from it. new_frame() and a write drop the copy.
+//
+
+#include <bit>
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+constexpr u32 ADDR = 0x33099E50;
+constexpr u32 BASE = ADDR & ~(ReadCache::BLOCK - 1);
+
+auto cache() -> ReadCache& { return ReadCache::get(); }
+
+auto reads() -> std::vector<host::Read>& { return host::game().reads; }
+
+auto bits(float f) -> u32 { return std::bit_cast<u32>(f); }
+
+auto read(u32 addr) -> float {
+  float v = 0;
+
+  CHECK(cache().read_float(addr, v));
+
+  return v;
+}
+
+auto fresh() -> void {
+  host::reset();
+
+  PageCache::get().new_frame();
+  cache().new_frame();
+
+  host::game().write32(ADDR, bits(1.0f));
+  host::game().write32(ADDR + 8, bits(2.0f));
+}
+
+auto one_block_per_frame() -> void {
+  fresh();
+
+  auto before = cache().get_stats();
+
+  CHECK(read(ADDR) == 1.0f);
+  CHECK(read(ADDR + 8) == 2.0f);
+
+  CHECK(reads().size() == 1);
+  CHECK(reads().size() == 1 && reads()[0].addr == BASE &&
+        reads()[0].size == ReadCache::BLOCK);
+
+  auto after = cache().get_stats();
+
+  CHECK(after.misses - before.misses == 1);
+  CHECK(after.hits - before.hits == 1);
+  CHECK(after.uncached == before.uncached);
+}
+
+// the game changed the value: seen only from the next frame.
+auto snapshot() -> void {
+  fresh();
+
+  CHECK(read(ADDR) == 1.0f);
+
+  host::game().write32(ADDR, bits(4.0f));
+
+  CHECK(read(ADDR) == 1.0f);
+  CHECK(reads().size() == 1);
+
+  cache().new_frame();
+
+  CHECK(read(ADDR) == 4.0f);
+  CHECK(reads().size() == 2);
+}
+
+// a flushed writef() reaches the cache within the frame.
+auto invalidated_by_write() -> void {
+  fresh();
+
+  CHECK(read(ADDR) == 1.0f);
+
+  WriteBuffer::get().write(ADDR + 8, bits(3.0f));
+  WriteBuffer::get().flush();
+
+  CHECK(read(ADDR + 8) == 3.0f);
+  CHECK(reads().size() == 2);
+
+  // the rest of the block is loaded again with it.
+  CHECK(read(ADDR) == 1.0f);
+  CHECK(reads().size() == 2);
+}
+
+}  // namespace
+
+auto main() -> int {
+  one_block_per_frame();
+  snapshot();
+  invalidated_by_write();
+
+  return result("readcache");
+}
@@ -0,0 +1,189 @@
+//
+// Scheduler over frames: entries run by priority, each up to its own
+// budget of statements, and all within one frame budget. An entry that
+// ran out of either resumes at the statement it stopped at, and one the
+// frame budget skipped ages until it runs.
+//
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+// arguments of every nap(), in order.
+std::vector<i32> trace;
+
+// sleeps 1 ms, so 16 naps, one slice, are over a 3 ms frame budget.
+auto nap(NativeCall& call) -> Object {
+  trace.push_back(call.args[0].v_i32);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  return Object();
+}
+
+// naps first .. last, one statement each.
+auto naps(i32 first, i32 last) -> std::string {
+  std::string text;
+
+  for (i32 i = first; i <= last; i++)
+    text += "nap(" + std::to_string(i) + ")\n";
+
+  return text;
+}
+
+struct Entry {
+  MenuEntry entry;
+  EntryContext ctx;
+
+  Entry(std::string const& path)
+      : entry(path, NO_GAME_FUNC), ctx(path, &this->entry) {
+    this->entry.SetArg(&this->ctx);
+    host::activate(&this->entry);
+  }
+};
+
+struct Frames {
+  std::string base;
+  std::vector<std::unique_ptr<Entry>> entries;
+
+  Scheduler scheduler;
+
+  Frames(std::string const& base, Time frame_budget)
+      : base(base), scheduler(frame_budget) {
+    host::reset();
+  }
+
+  auto add(std::string const& text, u8 priority,
+           u32 budget = Scheduler::DEFAULT_BUDGET) -> EntryContext& {
+    auto path = this->base + "." + std::to_string(this->entries.size()) +
+                ".zlua";
+
+    write_file(path, text);
+
+    auto& e = *this->entries.emplace_back(std::make_unique<Entry>(path));
+
+    this->scheduler.add(&e.entry, priority, budget);
+
+    return e.ctx;
+  }
+
+  auto task(size_t i) -> Scheduler::Task const& {
+    return this->scheduler.get_tasks()[i];
+  }
+
+  // as main.cpp: the callbacks, then the scheduled scripts. the trace
+  // of this frame.
+  auto run() -> std::vector<i32> {
+    trace.clear();
+
+    PageCache::get().new_frame();
+    ReadCache::get().new_frame();
+
+    for (auto&& e : this->entries) e->ctx.prepare();
+
+    this->scheduler.run_frame();
+
+    WriteBuffer::get().flush();
+    host::new_frame();
+
+    return trace;
+  }
+};
+
+auto range(i32 first, i32 last) -> std::vector<i32> {
+  std::vector<i32> v;
+
+  for (i32 i = first; i <= last; i++) v.push_back(i);
+
+  return v;
+}
+
+// highest priority first, equal ones in the order added. an entry in
+// async mode is left to its AsyncRunner.
+auto priority_order(std::string const& base) -> void {
+  Frames f(base, Seconds(10));
+
+  f.add("nap(1)\n", 0);
+  f.add("nap(2)\n", 3);
+  f.add("nap(3)\n", 1);
+  f.add("nap(4)\n", 1);
+  f.add("nap(5)\n", 9).set_async(true);
+
+  CHECK(f.run() == std::vector<i32>({2, 3, 4, 1}));
+  CHECK(f.run() == std::vector<i32>({2, 3, 4, 1}));
+
+  CHECK(f.task(0).runs == 2);
+  CHECK(f.task(4).runs == 0);
+  CHECK(f.scheduler.get_late_frames() == 0);
+}
+
+// an entry out of its own budget stops for the frame, and the next
+// entry still runs.
+auto overruns(std::string const& base) -> void {
+  Frames f(base, Seconds(10));
+
+  f.add(naps(1, 5), 1, 3);
+  f.add("nap(100)\n", 0);
+
+  CHECK(f.run() == std::vector<i32>({1, 2, 3, 100}));
+  CHECK(f.task(0).overruns == 1 && f.task(0).runs == 0);
+
+  CHECK(f.run() == std::vector<i32>({4, 5, 100}));
+  CHECK(f.task(0).overruns == 1 && f.task(0).runs == 1);
+
+  CHECK(f.task(0).deferred == 0 && f.task(1).deferred == 0);
+  CHECK(f.scheduler.get_late_frames() == 0);
+}
+
+//
+// The first slice of `high` spends the frame budget: it stops there and
+// `low` is skipped. `high` resumes at the next statement, and `low`,
+// skipped twice, comes before it on the third frame.
+//
+auto frame_budget(std::string const& base) -> void {
+  Frames f(base, Milliseconds(3));
+
+  f.add(naps(1, 20), 1);
+  f.add("nap(100)\n", 0);
+
+  auto& high = f.task(0);
+  auto& low = f.task(1);
+
+  CHECK(f.run() == range(1, Scheduler::SLICE));
+  CHECK(high.deferred == 1 && high.runs == 0);
+  CHECK(low.deferred == 1 && low.age == 1);
+  CHECK(f.scheduler.get_late_frames() == 1);
+
+  // equal with `low`'s age, first by the order added.
+  CHECK(f.run() == range(Scheduler::SLICE + 1, 20));
+  CHECK(high.runs == 1);
+  CHECK(low.deferred == 2 && low.age == 2);
+  CHECK(f.scheduler.get_late_frames() == 2);
+
+  auto third = f.run();
+
+  CHECK(!third.empty() && third[0] == 100);
+  CHECK(low.runs == 1 && low.age == 0);
+  CHECK(high.age == 0);
+  CHECK(f.scheduler.get_late_frames() == 3);
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  NativeRegistry::get().add("nap", nap, {TypeKind::I32});
+
+  auto base = std::string(argv[0]);
+
+  priority_order(base);
+  overruns(base);
+  frame_budget(base);
+
+  return result("scheduler");
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "host.hpp"
+#include "lua.hpp"
+
+//
+// Shared by the host tests: each tests/*.cpp is one program that exits
+// with 1 if a CHECK failed.
+//
+namespace test {
+
+using namespace CTRPluginFramework;
+using namespace CTRPluginFramework::lua;
+
+inline int failures = 0;
+
+// the menu is not run, entries need no callback.
+constexpr FuncPointer NO_GAME_FUNC = nullptr;
+
+#define CHECK(cond)                                                \
+  do {                                                             \
+    if (!(cond)) {                                                 \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, \
+                   __LINE__, #cond);                               \
+      test::failures++;                                            \
+    }                                                              \
+  } while (0)
+
+inline auto read_file(std::string const& path) -> std::string {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream ss;
+
+  ss << in.rdbuf();
+
+  return ss.str();
+}
+
+// also removes a .zluac left by an earlier run.
+inline auto write_file(std::string const& path, std::string const& text)
+    -> void {
+  std::ofstream(path, std::ios::binary) << text;
+  std::remove((path + "c").c_str());
+}
+
+//
+// One frame as main.cpp runs it: the entry's callback, then the script,
+// then the buffered writes. false if there was nothing to run.
+//
+inline auto run_frame(EntryContext& ctx, u32& steps, VM::Status& status)
+    -> bool {
+  PageCache::get().new_frame();
+  ReadCache::get().new_frame();
+
+  bool ran = ctx.prepare();
+
+  if (ran) status = ctx.step(steps);
+
+  WriteBuffer::get().flush();
+  host::new_frame();
+
+  return ran;
+}
+
+inline auto result(char const* name) -> int {
+  if (failures) std::fprintf(stderr, "%s: %d failed\n", name, failures);
+
+  return failures ? 1 : 0;
+}
+
+}  // namespace test
@@ -0,0 +1,108 @@
+//
+// TypeInfer proves a read of a global only where a store to it ran on
+// every path before: counted as the typed operators the Compiler emits
+// for `x + 2.0`.
+//
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+// typed operators in the chunk built from text, -1 if it fails to build.
+auto typed_ops(std::string const& path, std::string const& text) -> int {
+  write_file(path, text);
+
+  SourceFile src(path);
+
+  if (!src.read() || !src.lexer->lex()) return -1;
+
+  EntryContext::parse(src);
+
+  if (!src.program) return -1;
+
+  Optimizer(&src).optimize(src.program);
+
+  if (!TypeInfer(&src).infer(src.program)) return -1;
+
+  src.chunk = src.compiler->compile(src.program);
+
+  if (!src.chunk) return -1;
+
+  int n = 0;
+
+  for (auto&& i : src.chunk->code) n += bc::is_typed(i.op());
+
+  return n;
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  // stored earlier in the same block.
+  CHECK(typed_ops(path, R"(
+if is_pressed(1) then
+  x = 1.0
+  y = x + 2.0
+end
+)") == 1);
+
+  // stored in an enclosing block.
+  CHECK(typed_ops(path, R"(
+if is_pressed(1) then
+  x = 1.0
+
+  if is_pressed(2) then
+    y = x + 2.0
+  end
+end
+)") == 1);
+
+  // stored on one branch only: x may still be None.
+  CHECK(typed_ops(path, R"(
+if is_pressed(1) then
+  x = 1.0
+end
+
+y = x + 2.0
+)") == 0);
+
+  CHECK(typed_ops(path, R"(
+if is_pressed(1) then
+  x = 1.0
+elseif is_pressed(2) then
+  x = 3.0
+end
+
+y = x + 2.0
+)") == 0);
+
+  // stored on every branch.
+  CHECK(typed_ops(path, R"(
+if is_pressed(1) then
+  x = 1.0
+elseif is_pressed(2) then
+  x = 3.0
+else
+  x = 4.0
+end
+
+y = x + 2.0
+)") == 1);
+
+  // stored in a sibling block that ran before, but not always.
+  CHECK(typed_ops(path, R"(
+if is_pressed(1) then
+  x = 1.0
+end
+
+if is_pressed(2) then
+  y = x + 2.0
+end
+)") == 0);
+
+  return result("typeinfer");
+}
@@ -0,0 +1,151 @@
+//
+// WriteBuffer as writef() uses it: writes to one address combine, the
+// last wins, adjacent ones go out as one copy at the flush, and readf()
+// sees a buffered value before that. An entry with write_through writes
+// at once instead.
+//
+
+#include <bit>
+
+#include "test.hpp"
+
+using namespace test;
+
+namespace {
+
+constexpr u32 ADDR = 0x33099E50;
+
+auto bits(float f) -> u32 { return std::bit_cast<u32>(f); }
+
+auto writes() -> std::vector<host::Write>& { return host::game().writes; }
+
+//
+// Runs `text` through once, up to the flush, which is left to the
+// caller. The stats of the WriteBuffer before the run are in `before`.
+//
+struct Run {
+  static auto written(std::string const& path, std::string const& text)
+      -> std::string const& {
+    write_file(path, text);
+    return path;
+  }
+
+  MenuEntry entry;
+  EntryContext ctx;
+
+  WriteBuffer::Stats before;
+
+  Run(std::string const& path, std::string const& text,
+      bool write_through = false)
+      : entry("writebuffer", NO_GAME_FUNC),
+        ctx(written(path, text), &this->entry) {
+    host::reset();
+    host::activate(&this->entry);
+
+    this->ctx.vm.write_through = write_through;
+    this->before = WriteBuffer::get().get_stats();
+
+    PageCache::get().new_frame();
+    ReadCache::get().new_frame();
+
+    u32 steps = VM::UNLIMITED;
+
+    CHECK(this->ctx.prepare());
+    CHECK(this->ctx.step(steps) == VM::Status::Done);
+  }
+
+  auto stats() const -> WriteBuffer::Stats {
+    auto s = WriteBuffer::get().get_stats();
+
+    return {
+        .issued = s.issued - this->before.issued,
+        .combined = s.combined - this->before.combined,
+        .flushed = s.flushed - this->before.flushed,
+        .failed = s.failed - this->before.failed,
+    };
+  }
+};
+
+auto last_wins(std::string const& path) -> void {
+  Run run(path, "writef(0x33099E50, 1.0)\nwritef(0x33099E50, 2.0)\n");
+
+  CHECK(writes().empty());
+
+  WriteBuffer::get().flush();
+
+  CHECK(writes().size() == 1);
+  CHECK(writes().size() == 1 && writes()[0].addr == ADDR &&
+        writes()[0].size == 4 && writes()[0].value == bits(2.0f));
+
+  auto s = run.stats();
+
+  CHECK(s.issued == 2 && s.combined == 1 && s.flushed == 1 && s.failed == 0);
+}
+
+// written out of address order, still one copy.
+auto adjacent(std::string const& path) -> void {
+  Run run(path,
+          "writef(0x33099E54, 2.0)\n"
+          "writef(0x33099E50, 1.0)\n"
+          "writef(0x33099E58, 3.0)\n");
+
+  WriteBuffer::get().flush();
+
+  CHECK(writes().size() == 1);
+  CHECK(writes().size() == 1 && writes()[0].addr == ADDR &&
+        writes()[0].size == 12 && writes()[0].value == bits(1.0f));
+
+  CHECK(host::game().read32(ADDR) == bits(1.0f));
+  CHECK(host::game().read32(ADDR + 4) == bits(2.0f));
+  CHECK(host::game().read32(ADDR + 8) == bits(3.0f));
+
+  auto s = run.stats();
+
+  CHECK(s.issued == 3 && s.combined == 0 && s.flushed == 1);
+}
+
+// every writef() is a copy of its own, made before the script returns.
+auto write_through(std::string const& path) -> void {
+  Run run(path, "writef(0x33099E50, 1.0)\nwritef(0x33099E50, 2.0)\n", true);
+
+  CHECK(writes().size() == 2);
+  CHECK(writes().size() == 2 && writes()[0].value == bits(1.0f) &&
+        writes()[1].value == bits(2.0f));
+
+  WriteBuffer::get().flush();
+
+  CHECK(writes().size() == 2);
+
+  auto s = run.stats();
+
+  CHECK(s.issued == 0 && s.flushed == 0);
+}
+
+auto read_pending(std::string const& path) -> void {
+  Run run(path,
+          "writef(0x33099E50, 5.0)\n"
+          "if readf(0x33099E50) == 5.0 then\n"
+          "  notify(\"pending\")\n"
+          "end\n");
+
+  CHECK(host::game().read32(ADDR) == 0);
+  CHECK(host::game().notifications.size() == 1 &&
+        host::game().notifications[0] == "pending");
+
+  WriteBuffer::get().flush();
+
+  CHECK(host::game().read32(ADDR) == bits(5.0f));
+}
+
+}  // namespace
+
+auto main(int, char** argv) -> int {
+  auto path = std::string(argv[0]) + ".zlua";
+
+  last_wins(path);
+  adjacent(path);
+  write_through(path);
+  read_pending(path);
+
+  return result("writebuffer");
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+//
+// Host stand-in for libctrpf's umbrella header. Only what src/lua, the
+// tests and zlua2cpp use is declared; tools/host/host.cpp defines it.
+//
+#include "CTRPluginFramework/Graphics/OSD.hpp"
+#include "CTRPluginFramework/Menu.hpp"
+#include "CTRPluginFramework/System.hpp"
+#include "CTRPluginFramework/Utils.hpp"
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace CTRPluginFramework {
+
+struct Color {
+  static const Color White;
+  static const Color Black;
+};
+
+inline const Color Color::White{};
+inline const Color Color::Black{};
+
+class OSD {
+ public:
+  static int Notify(const std::string& str,
+                    const Color& foreground = Color::White,
+                    const Color& background = Color::Black);
+};
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "Menu/MenuEntry.hpp"
+#include "Menu/PluginMenu.hpp"
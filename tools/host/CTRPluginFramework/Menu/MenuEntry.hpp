@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+namespace CTRPluginFramework {
+
+class MenuEntry;
+
+using FuncPointer = void (*)(MenuEntry*);
+
+// state is kept by tools/host/host.cpp, see host::activate().
+class MenuEntry {
+ public:
+  MenuEntry(const std::string& name, FuncPointer gameFunc,
+            const std::string& note = "");
+  ~MenuEntry();
+
+  void Disable();
+
+  void* GetArg() const;
+  void SetArg(void* arg);
+
+  bool IsActivated() const;
+  bool WasJustActivated() const;
+};
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../System/Time.hpp"
+#include "MenuEntry.hpp"
+
+namespace CTRPluginFramework {
+
+using FrameCallback = void (*)(Time);
+
+// never run on the host, it only collects the entries.
+class PluginMenu {
+ public:
+  PluginMenu(const std::string& name = "") : name(name) {}
+
+  void Append(MenuEntry* item) { this->entries.push_back(item); }
+
+  FrameCallback OnNewFrame = nullptr;
+
+ private:
+  std::string name;
+  std::vector<MenuEntry*> entries;
+};
+
+}  // namespace CTRPluginFramework
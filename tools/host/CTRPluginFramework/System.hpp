@@ -0,0 +1,7 @@
+#pragma once
+
+#include "System/Clock.hpp"
+#include "System/Controller.hpp"
+#include "System/File.hpp"
+#include "System/Process.hpp"
+#include "System/Time.hpp"
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Time.hpp"
+
+namespace CTRPluginFramework {
+
+class Clock {
+ public:
+  Clock();
+
+  Time GetElapsedTime() const;
+  bool HasTimePassed(Time time) const;
+  Time Restart();
+
+ private:
+  s64 _start;  // microseconds of std::chrono::steady_clock
+};
+
+}  // namespace CTRPluginFramework
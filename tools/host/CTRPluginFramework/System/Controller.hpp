@@ -0,0 +1,12 @@
+#pragma once
+
+#include "types.h"
+
+namespace CTRPluginFramework {
+
+class Controller {
+ public:
+  static bool IsKeysDown(u32 keys);
+};
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+#include "types.h"
+
+namespace CTRPluginFramework {
+
+class File {
+ public:
+  enum Mode {
+    READ = 1,
+    WRITE = 1 << 1,
+    CREATE = 1 << 2,
+    APPEND = 1 << 3,
+    TRUNCATE = 1 << 4,
+    SYNC = 1 << 5,
+    RW = READ | WRITE,
+    RWC = READ | WRITE | CREATE,
+  };
+
+  File(const std::string& path, u32 mode = READ | WRITE);
+  ~File();
+
+  static int Exists(const std::string& path);
+  static int Remove(const std::string& path);
+
+  int Read(void* buffer, u32 length) const;
+  int Write(const void* data, u32 length);
+
+  u64 GetSize() const;
+  bool IsOpen() const;
+  std::string GetName() const;
+};
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "types.h"
+
+// libctru's memory permissions, as taken by Process::CheckAddress().
+enum MemPerm {
+  MEMPERM_READ = 1,
+  MEMPERM_WRITE = 2,
+  MEMPERM_EXECUTE = 4,
+};
+
+namespace CTRPluginFramework {
+
+class Process {
+ public:
+  static bool CheckAddress(u32 address, u32 perm = MEMPERM_READ);
+  static bool CopyMemory(void* dst, const void* src, u32 size);
+  static void ReturnToHomeMenu();
+};
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "types.h"
+
+namespace CTRPluginFramework {
+
+// counted in microseconds on the host.
+class Time {
+ public:
+  constexpr Time() : _us(0) {}
+
+  constexpr float AsSeconds() const { return _us / 1000000.0f; }
+  constexpr int AsMilliseconds() const { return static_cast<int>(_us / 1000); }
+  constexpr s64 AsMicroseconds() const { return _us; }
+
+  static const Time Zero;
+
+ private:
+  friend constexpr Time Seconds(float amount);
+  friend constexpr Time Milliseconds(int amount);
+  friend constexpr Time Microseconds(s64 amount);
+
+  constexpr explicit Time(s64 us) : _us(us) {}
+
+  s64 _us;
+};
+
+inline constexpr Time Time::Zero{};
+
+constexpr Time Seconds(float amount) {
+  return Time(static_cast<s64>(amount * 1000000));
+}
+
+constexpr Time Milliseconds(int amount) {
+  return Time(static_cast<s64>(amount) * 1000);
+}
+
+constexpr Time Microseconds(s64 amount) { return Time(amount); }
+
+constexpr bool operator==(Time left, Time right) {
+  return left.AsMicroseconds() == right.AsMicroseconds();
+}
+
+constexpr bool operator<(Time left, Time right) {
+  return left.AsMicroseconds() < right.AsMicroseconds();
+}
+
+constexpr bool operator>(Time left, Time right) { return right < left; }
+constexpr bool operator<=(Time left, Time right) { return !(right < left); }
+constexpr bool operator>=(Time left, Time right) { return !(left < right); }
+
+constexpr Time operator+(Time left, Time right) {
+  return Microseconds(left.AsMicroseconds() + right.AsMicroseconds());
+}
+
+constexpr Time operator-(Time left, Time right) {
+  return Microseconds(left.AsMicroseconds() - right.AsMicroseconds());
+}
+
+constexpr Time& operator+=(Time& left, Time right) {
+  return left = left + right;
+}
+
+constexpr Time& operator-=(Time& left, Time right) {
+  return left = left - right;
+}
+
+}  // namespace CTRPluginFramework
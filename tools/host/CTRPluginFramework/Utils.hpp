@@ -0,0 +1,4 @@
+#pragma once
+
+#include "Utils/LineWriter.hpp"
+#include "Utils/Utils.hpp"
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include "../System/File.hpp"
+
+namespace CTRPluginFramework {
+
+// writes nothing on the host.
+class LineWriter {
+ public:
+  LineWriter(File& output);
+  LineWriter(const LineWriter& right) = delete;
+  ~LineWriter();
+
+  LineWriter& operator<<(const std::string& input);
+  static const std::string& endl();
+  int Flush();
+};
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+namespace CTRPluginFramework {
+
+class Utils {
+ public:
+  static std::string Format(const char* fmt, ...);
+};
+
+}  // namespace CTRPluginFramework
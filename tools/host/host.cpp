@@ -0,0 +1,354 @@
+//
+// Host stand-ins for libctrpf, see host.hpp.
+//
+// File and MenuEntry keep their state here by object address, so
+// nothing depends on their private members.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "host.hpp"
+
+namespace CTRPluginFramework {
+
+using host::Write;
+
+namespace {
+
+struct EntryState {
+  void* arg = nullptr;
+  bool on = false;
+  bool just = false;
+};
+
+struct State {
+  std::mutex mutex;
+
+  std::unordered_map<File const*, FILE*> files;
+  std::unordered_map<File const*, std::string> names;
+  std::unordered_map<MenuEntry const*, EntryState> entries;
+
+  host::Game game;
+};
+
+auto state() -> State& {
+  static auto& inst = *new State();
+  return inst;
+}
+
+auto file_of(File const* f) -> FILE* {
+  std::lock_guard lock(state().mutex);
+
+  auto it = state().files.find(f);
+
+  return it == state().files.end() ? nullptr : it->second;
+}
+
+auto entry_of(MenuEntry const* e) -> EntryState& {
+  return state().entries[e];
+}
+
+auto in_game(uintptr_t addr, u32 size) -> bool {
+  return addr >= host::MEMORY_BEGIN && addr + size <= host::MEMORY_END;
+}
+
+// every page of [addr, addr + size) is mapped, and writable if `write`.
+auto mapped(host::Game const& game, uintptr_t addr, u32 size, bool write)
+    -> bool {
+  if (!in_game(addr, size)) return false;
+
+  for (u32 page = addr / host::Game::PAGE_SIZE;
+       page <= (addr + size - 1) / host::Game::PAGE_SIZE; page++)
+    if (game.unmapped.count(page) || (write && game.read_only.count(page)))
+      return false;
+
+  return true;
+}
+
+auto now_us() -> s64 {
+  using namespace std::chrono;
+
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+//
+// host.hpp
+//
+
+namespace host {
+
+auto Game::byte(u32 addr) -> u8& {
+  return this->pages[addr / PAGE_SIZE][addr % PAGE_SIZE];
+}
+
+auto Game::read32(u32 addr) -> u32 {
+  u32 v = 0;
+
+  for (u32 i = 0; i < sizeof(u32); i++) v |= this->byte(addr + i) << (i * 8);
+
+  return v;
+}
+
+auto Game::write32(u32 addr, u32 value) -> void {
+  for (u32 i = 0; i < sizeof(u32); i++) this->byte(addr + i) = value >> (i * 8);
+}
+
+auto game() -> Game& { return state().game; }
+
+auto reset() -> void { state().game = Game(); }
+
+auto activate(MenuEntry* e) -> void {
+  std::lock_guard lock(state().mutex);
+
+  auto& s = entry_of(e);
+
+  s.just = !s.on;
+  s.on = true;
+}
+
+auto new_frame() -> void {
+  std::lock_guard lock(state().mutex);
+
+  for (auto&& [_, s] : state().entries) s.just = false;
+}
+
+}  // namespace host
+
+//
+// Utils, OSD, Controller, Process
+//
+
+std::string Utils::Format(const char* fmt, ...) {
+  char buf[512];
+
+  va_list args;
+  va_start(args, fmt);
+  std::vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  return buf;
+}
+
+int OSD::Notify(const std::string& str, const Color&, const Color&) {
+  std::lock_guard lock(state().mutex);
+
+  state().game.notifications.push_back(str);
+
+  return 0;
+}
+
+bool Controller::IsKeysDown(u32 keys) {
+  return (state().game.keys & keys) == keys;
+}
+
+bool Process::CheckAddress(u32 address, u32 perm) {
+  std::lock_guard lock(state().mutex);
+
+  state().game.checks++;
+
+  return mapped(state().game, address, 1, perm & MEMPERM_WRITE);
+}
+
+// the worker of an AsyncRunner reads while the game thread writes.
+bool Process::CopyMemory(void* dst, const void* src, u32 size) {
+  auto to = reinterpret_cast<uintptr_t>(dst);
+  auto from = reinterpret_cast<uintptr_t>(src);
+
+  std::lock_guard lock(state().mutex);
+
+  auto& game = state().game;
+
+  if (in_game(to, size)) {
+    if (!mapped(game, to, size, true)) return false;
+
+    Write w{static_cast<u32>(to), size, 0};
+
+    std::memcpy(&w.value, src, std::min<u32>(size, sizeof(u32)));
+
+    for (u32 i = 0; i < size; i++)
+      game.byte(to + i) = static_cast<u8 const*>(src)[i];
+
+    game.writes.push_back(w);
+  }
+  else if (in_game(from, size)) {
+    if (!mapped(game, from, size, false)) return false;
+
+    for (u32 i = 0; i < size; i++)
+      static_cast<u8*>(dst)[i] = game.byte(from + i);
+
+    game.reads.push_back({static_cast<u32>(from), size});
+  }
+  else
+    return false;
+
+  return true;
+}
+
+void Process::ReturnToHomeMenu() { std::abort(); }
+
+//
+// Clock, on the host's steady clock.
+//
+
+Clock::Clock() : _start(now_us()) {}
+
+Time Clock::GetElapsedTime() const {
+  return Microseconds(now_us() - this->_start);
+}
+
+bool Clock::HasTimePassed(Time time) const {
+  return this->GetElapsedTime() >= time;
+}
+
+Time Clock::Restart() {
+  s64 now = now_us();
+  Time elapsed = Microseconds(now - this->_start);
+
+  this->_start = now;
+
+  return elapsed;
+}
+
+//
+// File
+//
+
+File::File(const std::string& path, u32 mode) {
+  char const* m = "rb";
+
+  if (mode & TRUNCATE)
+    m = "w+b";
+  else if (mode & WRITE)
+    m = Exists(path) == 1 ? "r+b" : (mode & CREATE) ? "w+b" : nullptr;
+
+  FILE* fp = m ? std::fopen(path.c_str(), m) : nullptr;
+
+  std::lock_guard lock(state().mutex);
+
+  state().files[this] = fp;
+  state().names[this] = path;
+}
+
+File::~File() {
+  std::lock_guard lock(state().mutex);
+
+  if (auto fp = state().files[this]) std::fclose(fp);
+
+  state().files.erase(this);
+  state().names.erase(this);
+}
+
+int File::Exists(const std::string& path) {
+  FILE* fp = std::fopen(path.c_str(), "rb");
+
+  if (!fp) return 0;
+
+  std::fclose(fp);
+  return 1;
+}
+
+int File::Remove(const std::string& path) { return std::remove(path.c_str()); }
+
+int File::Read(void* buffer, u32 length) const {
+  FILE* fp = file_of(this);
+
+  return fp && std::fread(buffer, 1, length, fp) == length ? 0 : -1;
+}
+
+int File::Write(const void* data, u32 length) {
+  FILE* fp = file_of(this);
+
+  return fp && std::fwrite(data, 1, length, fp) == length ? 0 : -1;
+}
+
+u64 File::GetSize() const {
+  FILE* fp = file_of(this);
+
+  if (!fp) return 0;
+
+  long at = std::ftell(fp);
+
+  std::fseek(fp, 0, SEEK_END);
+  long size = std::ftell(fp);
+  std::fseek(fp, at, SEEK_SET);
+
+  return size;
+}
+
+bool File::IsOpen() const { return file_of(this) != nullptr; }
+
+std::string File::GetName() const {
+  std::lock_guard lock(state().mutex);
+
+  return state().names[this];
+}
+
+//
+// LineWriter: only for Logger, which has no file on the host.
+//
+
+LineWriter::~LineWriter() {}
+
+LineWriter& LineWriter::operator<<(const std::string&) { return *this; }
+
+const std::string& LineWriter::endl() {
+  static std::string const inst = "\n";
+  return inst;
+}
+
+int LineWriter::Flush() { return 0; }
+
+//
+// MenuEntry
+//
+
+MenuEntry::MenuEntry(const std::string&, FuncPointer, const std::string&) {}
+
+MenuEntry::~MenuEntry() {
+  std::lock_guard lock(state().mutex);
+
+  state().entries.erase(this);
+}
+
+void MenuEntry::Disable() {
+  std::lock_guard lock(state().mutex);
+
+  entry_of(this).on = false;
+}
+
+void* MenuEntry::GetArg() const {
+  std::lock_guard lock(state().mutex);
+
+  return entry_of(this).arg;
+}
+
+void MenuEntry::SetArg(void* arg) {
+  std::lock_guard lock(state().mutex);
+
+  entry_of(this).arg = arg;
+}
+
+bool MenuEntry::IsActivated() const {
+  std::lock_guard lock(state().mutex);
+
+  return entry_of(this).on;
+}
+
+bool MenuEntry::WasJustActivated() const {
+  std::lock_guard lock(state().mutex);
+
+  return entry_of(this).just;
+}
+
+}  // namespace CTRPluginFramework
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "CTRPluginFramework.hpp"
+
+//
+// Host stand-ins for the libctrpf calls made by src/lua, for zlua2cpp and
+// the host tests and benchmarks. The game is simulated: its memory is
+// the range MEMORY_BEGIN .. MEMORY_END, keys are set by the test, and
+// notifications are kept to be checked.
+//
+namespace CTRPluginFramework::host {
+
+// the game's heap. every address in it is valid.
+static constexpr u32 MEMORY_BEGIN = 0x30000000;
+static constexpr u32 MEMORY_END = 0x40000000;
+
+struct Write {
+  u32 addr;
+  u32 size;
+  u32 value;  // the first 4 bytes written
+};
+
+struct Read {
+  u32 addr;
+  u32 size;
+};
+
+struct Game {
+  static constexpr u32 PAGE_SIZE = 0x1000;
+
+  // zero until written.
+  std::unordered_map<u32, std::array<u8, PAGE_SIZE>> pages;
+
+  // page numbers, addr / PAGE_SIZE, taken out of the heap: unmapped
+  // fail every check and copy, read_only fail them for writing.
+  std::unordered_set<u32> unmapped;
+  std::unordered_set<u32> read_only;
+
+  // Process::CheckAddress() calls.
+  u32 checks = 0;
+
+  // every Process::CopyMemory() into and out of the game, in order.
+  std::vector<Write> writes;
+  std::vector<Read> reads;
+
+  // held for Controller::IsKeysDown().
+  u32 keys = 0;
+
+  // every OSD::Notify(), in order.
+  std::vector<std::string> notifications;
+
+  auto byte(u32 addr) -> u8&;
+
+  auto read32(u32 addr) -> u32;
+  auto write32(u32 addr, u32 value) -> void;
+};
+
+auto game() -> Game&;
+
+// back to zeroed memory, no keys, no writes and nothing notified.
+auto reset() -> void;
+
+//
+// MenuEntry: turn it on as the menu would. WasJustActivated() is true
+// until the next new_frame().
+//
+auto activate(MenuEntry* e) -> void;
+
+auto new_frame() -> void;
+
+}  // namespace CTRPluginFramework::host
@@ -0,0 +1,314 @@
+#include <cstdio>
+
+#include "Emitter.hpp"
+#include "lua/Interner.hpp"
+#include "lua/Native.hpp"
+#include "lua/ObjectOps.hpp"
+
+namespace CTRPluginFramework::lua {
+
+namespace {
+
+// as spelled in C++, same order as BinOp / TypeKind.
+constexpr char const* BINOP_NAMES[] = {
+    "Mul",  "Div",     "Mod",   "Add",      "Sub",    "LShift", "RShift",
+    "Less", "Greater", "Equal", "NotEqual", "BitAnd", "BitXor", "BitOr",
+};
+
+static_assert(std::size(BINOP_NAMES) == ops::NUM_OPS);
+
+constexpr char const* KIND_NAMES[] = {
+    "None", "I32", "U32", "Float", "Bool", "Str",
+};
+
+static_assert(std::size(KIND_NAMES) == ops::NUM_KINDS);
+
+auto binop_name(BinOp op) -> std::string {
+  return std::string("BinOp::") + BINOP_NAMES[static_cast<size_t>(op)];
+}
+
+auto kind_name(TypeKind k) -> std::string {
+  return std::string("TypeKind::") + KIND_NAMES[static_cast<size_t>(k)];
+}
+
+auto hex(u32 v) -> std::string {
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "0x%08X", v);
+  return buf;
+}
+
+}  // namespace
+
+auto Emitter::line(std::string const& s, int indent) -> void {
+  this->out.append(indent * 2, ' ');
+  this->out += s;
+  this->out += '\n';
+}
+
+auto Emitter::rk(u8 x) -> std::string {
+  if (x >= bc::RK_CONST) return "K[" + std::to_string(x - bc::RK_CONST) + "]";
+
+  return "R[" + std::to_string(x) + "]";
+}
+
+// octal escapes are at most 3 digits, so a following digit is safe.
+auto Emitter::quote(string_view s) -> std::string {
+  std::string r = "\"";
+
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\')
+      r += '\\', r += c;
+    else if (c < 0x20 || c >= 0x7F) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\%03o", c);
+      r += buf;
+    }
+    else
+      r += c;
+  }
+
+  return r + "\"";
+}
+
+auto Emitter::find_positions() -> void {
+  auto& code = this->chunk.code;
+
+  this->resume_at.assign(code.size() + 1, false);
+  this->jumped_to.assign(code.size() + 1, false);
+  this->native_index.assign(NativeRegistry::get().size(), -1);
+  this->native_names.clear();
+
+  this->resume_at[0] = true;
+  this->resume_at[this->chunk.body] = true;
+
+  for (u32 pc = 0; pc < code.size(); pc++) {
+    auto i = code[pc];
+
+    if (i.is_stmt()) this->resume_at[pc] = true;
+
+    switch (i.op()) {
+      case OpCode::Jmp:
+      case OpCode::JmpIfFalse:
+        this->jumped_to[pc + 1 + i.sbx()] = true;
+        break;
+
+      case OpCode::CallNative:
+        this->resume_at[pc + 1] = true;
+
+        if (auto& n = this->native_index[i.b()]; n < 0) {
+          n = this->native_names.size();
+          this->native_names.push_back(NativeRegistry::get()[i.b()].name);
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+auto Emitter::emit_instruction(u32 pc, bc::Instruction i) -> void {
+  auto a = std::to_string(i.a());
+  auto at = std::to_string(pc);
+
+  if (i.is_stmt())
+    this->line("if (f.steps-- == 0) return f.preempt(" + at + ");", 3);
+
+  switch (i.op()) {
+    case OpCode::Nop:
+      this->line(";", 3);
+      break;
+
+    case OpCode::LoadK:
+      this->line("R[" + a + "] = K[" + std::to_string(i.bx()) + "];", 3);
+      break;
+
+    case OpCode::Move:
+      this->line("R[" + a + "] = R[" + std::to_string(i.b()) + "];", 3);
+      break;
+
+    case OpCode::GetGlobal:
+      this->line("R[" + a + "] = G[" + std::to_string(i.bx()) + "];", 3);
+      break;
+
+    case OpCode::SetGlobal:
+      this->line("G[" + std::to_string(i.bx()) + "] = R[" + a + "];", 3);
+      break;
+
+    case OpCode::Jmp:
+      this->line("goto L" + std::to_string(pc + 1 + i.sbx()) + ";", 3);
+      break;
+
+    case OpCode::JmpIfFalse:
+      this->line("if (!R[" + a + "].v_bool) goto L" +
+                     std::to_string(pc + 1 + i.sbx()) + ";",
+                 3);
+      break;
+
+    case OpCode::CallNative:
+      this->line("R[" + a + "] = f.invoke(*N[" +
+                     std::to_string(this->native_index[i.b()]) + "], &R[" +
+                     std::to_string(i.a() + 1) + "], " +
+                     std::to_string(i.c()) + ");",
+                 3);
+      this->line("if (f.call.suspend) return f.suspend(" +
+                     std::to_string(pc + 1) + ");",
+                 3);
+      break;
+
+    case OpCode::Halt:
+      this->line("return Status::Done;", 3);
+      break;
+
+    default: {
+      auto operands = rk(i.b()) + ", " + rk(i.c()) + ");";
+
+      if (bc::is_typed(i.op())) {
+        auto t = bc::typed_index(i.op());
+        auto op = static_cast<BinOp>(t % ops::NUM_OPS);
+        auto k = kind_name(ops::TYPED_KINDS[t / ops::NUM_OPS]);
+
+        this->line("R[" + a + "] = ops::kernel<" + binop_name(op) + ", " + k +
+                       ", " + k + ">(" + operands,
+                   3);
+      }
+      else {
+        this->line("R[" + a + "] = binary_op(" +
+                       binop_name(bc::binop_of(i.op())) + ", " + operands,
+                   3);
+      }
+      break;
+    }
+  }
+}
+
+auto Emitter::emit_run() -> void {
+  auto& code = this->chunk.code;
+
+  this->line("auto run(VM::Frame& f) -> Status {");
+
+  if (!this->native_names.empty()) {
+    this->line("static NativeFunction const* const N[] = {", 1);
+
+    for (auto&& name : this->native_names)
+      this->line("&native(" + quote(name) + "),", 3);
+
+    this->line("};", 1);
+    this->line("");
+  }
+
+  this->line("[[maybe_unused]] Object* R = f.R;", 1);
+  this->line("[[maybe_unused]] Object* G = f.G;", 1);
+  this->line("[[maybe_unused]] Object const* K = f.K;", 1);
+  this->line("");
+  this->line("switch (f.pc) {", 1);
+
+  for (u32 pc = 0; pc < code.size(); pc++) {
+    if (this->resume_at[pc]) {
+      // the previous instruction may run into this one.
+      if (pc > 0 && code[pc - 1].op() != OpCode::Jmp &&
+          code[pc - 1].op() != OpCode::Halt)
+        this->line("[[fallthrough]];", 3);
+
+      this->line("case " + std::to_string(pc) + ":", 2);
+    }
+
+    if (this->jumped_to[pc]) this->line("L" + std::to_string(pc) + ":", 2);
+
+    this->emit_instruction(pc, code[pc]);
+  }
+
+  this->line("}", 1);
+  this->line("");
+  this->line("return Status::Done;", 1);
+  this->line("}");
+}
+
+auto Emitter::emit_tables(std::string const& path, std::string const& name)
+    -> void {
+  auto& interner = Interner::get();
+
+  if (!this->chunk.constants.empty()) {
+    this->line("AotScript::Constant const constants[] = {");
+
+    for (auto&& k : this->chunk.constants) {
+      if (k.type.kind == TypeKind::Str)
+        this->line("{TypeKind::Str, 0, " + quote(interner.view(k.v_str)) + "},",
+                   2);
+      else
+        this->line("{" + kind_name(k.type.kind) + ", " + hex(k.v_u32) +
+                       ", nullptr},",
+                   2);
+    }
+
+    this->line("};");
+    this->line("");
+  }
+
+  if (!this->chunk.globals.empty()) {
+    this->line("char const* const globals[] = {");
+
+    for (auto&& id : this->chunk.globals)
+      this->line(quote(interner.view(id)) + ",", 2);
+
+    this->line("};");
+    this->line("");
+  }
+
+  if (!this->native_names.empty()) {
+    this->line("char const* const natives[] = {");
+
+    for (auto&& n : this->native_names) this->line(quote(n) + ",", 2);
+
+    this->line("};");
+    this->line("");
+  }
+
+  this->line("}  // namespace");
+  this->line("");
+  this->line("extern AotScript const " + name + " = {");
+  this->line(".path = " + quote(path) + ",", 2);
+  this->line(".run = run,", 2);
+  this->line(".body = " + std::to_string(this->chunk.body) + ",", 2);
+  this->line(".num_regs = " + std::to_string(this->chunk.num_regs) + ",", 2);
+  auto table = [&](char const* field, bool empty) {
+    this->line(std::string(".") + field + " = " + (empty ? "{}" : field) + ",",
+               2);
+  };
+
+  table("constants", this->chunk.constants.empty());
+  table("globals", this->chunk.globals.empty());
+  table("natives", this->native_names.empty());
+  this->line("};");
+}
+
+auto Emitter::emit(std::string const& path, std::string const& name)
+    -> std::string {
+  this->out.clear();
+
+  this->find_positions();
+
+  this->line("// generated by zlua2cpp from " + path + ", do not edit.");
+  this->line("");
+  this->line("#include \"lua/Aot.hpp\"");
+  this->line("");
+  this->line("namespace CTRPluginFramework::lua::aot {");
+  this->line("");
+  this->line("namespace {");
+  this->line("");
+  this->line("using Status = VM::Status;");
+  this->line("");
+
+  this->emit_run();
+
+  this->line("");
+
+  this->emit_tables(path, name);
+
+  this->line("");
+  this->line("}  // namespace CTRPluginFramework::lua::aot");
+
+  return this->out;
+}
+
+}  // namespace CTRPluginFramework::lua
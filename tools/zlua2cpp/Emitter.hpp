@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "lua/ByteCode.hpp"
+
+namespace CTRPluginFramework::lua {
+
+//
+// Writes a bc::Chunk as a C++ translation unit that defines one
+// AotScript (see lua/Aot.hpp).
+//
+// Each instruction becomes one C++ statement. Positions the VM can stop
+// at (statement starts, and after calls that may wait()) get a `case`
+// of the switch on Frame::pc, and jump targets a label, so the code
+// stops and resumes exactly where VM::exec() would.
+//
+class Emitter {
+  using OpCode = bc::OpCode;
+
+  bc::Chunk const& chunk;
+
+  std::string out;
+
+  // position -> may resume there / is jumped to
+  std::vector<bool> resume_at;
+  std::vector<bool> jumped_to;
+
+  // registry index -> index in the generated N[], -1 if not called
+  std::vector<int> native_index;
+  std::vector<char const*> native_names;
+
+  auto line(std::string const& s, int indent = 0) -> void;
+
+  auto find_positions() -> void;
+
+  auto emit_run() -> void;
+
+  auto emit_instruction(u32 pc, bc::Instruction i) -> void;
+
+  auto emit_tables(std::string const& path, std::string const& name)
+      -> void;
+
+  static auto rk(u8 x) -> std::string;
+
+  static auto quote(string_view s) -> std::string;
+
+ public:
+  Emitter(bc::Chunk const& chunk) : chunk(chunk) {}
+
+  // `name` is the identifier of the AotScript in lua::aot.
+  auto emit(std::string const& path, std::string const& name) -> std::string;
+};
+
+}  // namespace CTRPluginFramework::lua
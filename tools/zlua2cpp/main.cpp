@@ -0,0 +1,102 @@
+//
+// zlua2cpp: compiles a .zlua script ahead of time to a C++ translation
+// unit for the plugin, see lua/Aot.hpp.
+//
+//   zlua2cpp <script.zlua> <out.cpp> [name]
+//
+// Runs on the host with the plugin's own front end, Resolver, Optimizer,
+// TypeInfer and Compiler, then writes the chunk with Emitter. libctrpf
+// is stood in for by tools/host.
+//
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+
+#include "Emitter.hpp"
+#include "lua/Compiler.hpp"
+#include "lua/Lexer.hpp"
+#include "lua/Optimizer.hpp"
+#include "lua/Parser.hpp"
+#include "lua/Resolver.hpp"
+#include "lua/SourceFile.hpp"
+#include "lua/TypeInfer.hpp"
+
+using namespace CTRPluginFramework;
+using namespace CTRPluginFramework::lua;
+
+namespace {
+
+// the steps of EntryContext::build(), without the cache.
+auto build(SourceFile& src) -> bool {
+  if (!src.lexer->lex()) return false;
+
+  src.program = src.parser->parse();
+
+  if (!src.program || !Resolver(&src).resolve(src.program)) return false;
+
+  Optimizer(&src).optimize(src.program);
+
+  if (!TypeInfer(&src).infer(src.program)) return false;
+
+  src.chunk = src.compiler->compile(src.program);
+
+  return src.chunk != nullptr;
+}
+
+// "examples/coord-mod.zlua" -> "coord_mod"
+auto symbol_of(std::string const& path) -> std::string {
+  auto name = path.substr(path.find_last_of('/') + 1);
+
+  name = name.substr(0, name.find('.'));
+
+  for (auto&& c : name)
+    if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+    name = "_" + name;
+
+  return name;
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s <script.zlua> <out.cpp> [name]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::string path = argv[1];
+  std::string name = argc > 3 ? argv[3] : symbol_of(path);
+
+  SourceFile src(path);
+
+  if (!src.read()) {
+    std::fprintf(stderr, "%s: cannot read.\n", path.c_str());
+    return 1;
+  }
+
+  if (!build(src)) {
+    for (auto&& e : src.errors)
+      std::fprintf(stderr, "%s:%zu:%zu: %s\n", path.c_str(), e->line,
+                   e->column, e->msg.c_str());
+
+    std::fprintf(stderr, "%s: failed to compile.\n", path.c_str());
+    return 1;
+  }
+
+  // on the console the script sits next to the plugin.
+  auto script = path.substr(path.find_last_of('/') + 1);
+  auto text = Emitter(*src.chunk).emit(script, name);
+
+  std::ofstream out(argv[2], std::ios::binary);
+
+  if (!(out << text)) {
+    std::fprintf(stderr, "%s: cannot write.\n", argv[2]);
+    return 1;
+  }
+
+  return 0;
+}